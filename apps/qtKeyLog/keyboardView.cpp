@@ -4,7 +4,9 @@
 
 #include <QFile>
 #include <QMap>
+#include <QPaintEvent>
 #include <QPainter>
+#include <QPolygonF>
 #include <QTransform>
 
 #ifdef _WIN32
@@ -27,6 +29,13 @@ constexpr qreal g_minScaledFontSize{ 6.0 };
 constexpr qreal g_twoLineFontFactor{ 0.22 };
 constexpr qreal g_oneLineFontFactor{ 0.25 };
 constexpr qreal g_smallFontScale{ 0.85 };
+constexpr qreal g_viewPadding{ 12.0 };
+
+const QColor g_backgroundColor{ 35, 38, 40 };
+const QColor g_outlineColor{ 160, 150, 130 };
+const QColor g_labelColor{ 240, 240, 240 };
+// Room around a key's rect for the antialiased outline.
+constexpr int g_dirtyMargin{ 2 };
 
 constexpr std::uint32_t g_vkBack{ 0x08 };
 constexpr std::uint32_t g_vkTab{ 0x09 };
@@ -120,15 +129,29 @@ KeyboardView::KeyboardView(QWidget* parent) : QWidget{ parent }
 
 void KeyboardView::setKeyIdMode(KeyIdMode newMode)
 {
+    if (!m_virtualKeysAvailable)
+    {
+        newMode = KeyIdMode::scanCode;
+    }
     if (m_mode == newMode)
     {
         return;
     }
     m_mode = newMode;
-    m_pressedKeys.clear();
+    m_pressedKeys.reset();
+    rebuildKeyLookup();
     update();
 }
 
+void KeyboardView::setVirtualKeysAvailable(bool available)
+{
+    m_virtualKeysAvailable = available;
+    if (!available)
+    {
+        setKeyIdMode(KeyIdMode::scanCode);
+    }
+}
+
 KeyboardView::KeyIdMode KeyboardView::getKeyIdMode() const
 {
     return m_mode;
@@ -136,19 +159,30 @@ KeyboardView::KeyIdMode KeyboardView::getKeyIdMode() const
 
 void KeyboardView::resetPressedKeys()
 {
-    m_pressedKeys.clear();
+    m_pressedKeys.reset();
     update();
 }
 
 void KeyboardView::resetTestedKeys()
 {
-    m_testedKeys.clear();
+    m_testedKeys.reset();
+    update();
+}
+
+void KeyboardView::resetChatter()
+{
+    m_chatter.reset();
     update();
 }
 
 std::size_t KeyboardView::getPressedKeyCount() const
 {
-    return m_pressedKeys.size();
+    return m_pressedKeys.count();
+}
+
+const inputTester::chatterDetector& KeyboardView::getChatterDetector() const
+{
+    return m_chatter;
 }
 
 void KeyboardView::handleInputEvent(const inputTester::inputEvent& event)
@@ -161,21 +195,80 @@ void KeyboardView::handleInputEvent(const inputTester::inputEvent& event)
     {
         return;
     }
+    // Chatter is tracked by scan code in either mode: left and right Shift, Ctrl and the two Enters share a VK,
+    // so rolling from one to the other would read as a bounce.
+    const auto scanId{ scanIdForEvent(event) };
+    if (scanId != 0 && scanId < g_keyIdCount &&
+        (event.kind == inputTester::eventKind::keyDown || event.kind == inputTester::eventKind::keyUp) &&
+        m_chatter.record(scanId, event.kind == inputTester::eventKind::keyDown, event.sourceTimestampNs))
+    {
+        markScanIdDirty(scanId);
+    }
+
     const auto keyId{ keyIdForEvent(event) };
-    if (keyId == 0)
+    if (keyId == 0 || keyId >= g_keyIdCount)
     {
         return;
     }
 
+    // Repeats and releases of keys that were not down change nothing on screen.
+    const bool wasPressed{ m_pressedKeys[keyId] };
+    bool changed{ false };
     if (event.kind == inputTester::eventKind::keyDown)
     {
-        m_pressedKeys.insert(keyId);
-        m_testedKeys.insert(keyId);
+        changed = !(wasPressed && m_testedKeys[keyId]);
+        m_pressedKeys[keyId] = true;
+        m_testedKeys[keyId] = true;
     }
     else if (event.kind == inputTester::eventKind::keyUp)
     {
-        m_pressedKeys.erase(keyId);
+        changed = wasPressed;
+        m_pressedKeys[keyId] = false;
+    }
+    m_dirtyKeys[keyId] = m_dirtyKeys[keyId] || changed;
+}
+
+void KeyboardView::markScanIdDirty(std::uint32_t scanId)
+{
+    // Only on a bounce, so a scan over the keys is cheap enough.
+    for (std::size_t index{ 0 }; index < m_scanIds.size(); ++index)
+    {
+        if (m_scanIds[index] == scanId)
+        {
+            m_dirtyKeys[m_keyIds[index]] = true;
+        }
+    }
+}
+
+void KeyboardView::flushUpdates()
+{
+    if (m_dirtyKeys.none())
+    {
+        return;
+    }
+    for (std::uint32_t keyId{ 0 }; keyId < g_keyIdCount; ++keyId)
+    {
+        if (m_dirtyKeys[keyId])
+        {
+            invalidateKey(keyId);
+        }
+    }
+    m_dirtyKeys.reset();
+}
+
+void KeyboardView::setLatencyTrace(inputTester::latencyTrace* trace)
+{
+    m_latencyTrace = trace;
+}
+
+void KeyboardView::setSpriteCache(bool enabled)
+{
+    if (m_spriteCache == enabled)
+    {
+        return;
     }
+    m_spriteCache = enabled;
+    rebuildRenderCache();
     update();
 }
 
@@ -186,125 +279,297 @@ QSize KeyboardView::sizeHint() const
 
 void KeyboardView::paintEvent(QPaintEvent* event)
 {
-    Q_UNUSED(event)
+    paintKeyboard(event->region());
+    if (m_latencyTrace != nullptr)
+    {
+        // Drawn into the backing store; the compositor's flip to the screen comes on top of this.
+        m_latencyTrace->stampPainted(inputTester::nowTimestampNs());
+    }
+}
+
+void KeyboardView::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    // A drag-resize sends many of these per frame; the next paint rebuilds the cache once for the final size.
+    m_renderCache.clear();
+}
 
+void KeyboardView::paintKeyboard(const QRegion& region)
+{
     QPainter painter{ this };
     painter.setRenderHint(QPainter::Antialiasing, true);
 
-    const QColor backgroundColor{ 35, 38, 40 };
-    painter.fillRect(rect(), backgroundColor);
+    // The painter is clipped to region, so this only touches the dirty area.
+    painter.fillRect(rect(), g_backgroundColor);
 
     if (m_keys.empty() || m_sceneRect.isEmpty())
     {
         return;
     }
+    // A failed mapping load leaves new geometry without its lookup.
+    if (m_keyIds.size() != m_keys.size())
+    {
+        rebuildKeyLookup();
+    }
+    // Moving to a screen with another scale factor needs sprites at the new resolution.
+    if (m_renderCache.size() != m_keys.size() || (m_spriteCache && m_spritePixelRatio != devicePixelRatioF()))
+    {
+        rebuildRenderCache();
+    }
 
-    constexpr qreal padding{ 12.0 };
-
-    const qreal availableWidth{ width() - 2.0 * padding };
-    const qreal availableHeight{ height() - 2.0 * padding };
+    for (std::size_t index{ 0 }; index < m_keys.size(); ++index)
+    {
+        const auto& cache{ m_renderCache[index] };
+        if (!region.intersects(cache.screenRect))
+        {
+            continue;
+        }
+        const auto visual{ visualFor(index) };
+        const auto& sprite{ cache.sprites[static_cast<std::size_t>(visual)] };
+        if (sprite.isNull())
+        {
+            drawKey(painter, m_keys[index], cache, visual);
+        }
+        else
+        {
+            painter.drawPixmap(cache.screenRect.topLeft(), sprite);
+        }
+    }
+}
 
-    const qreal scaleX{ availableWidth / m_sceneRect.width() };
-    const qreal scaleY{ availableHeight / m_sceneRect.height() };
-    const qreal scale{ std::min(scaleX, scaleY) };
+void KeyboardView::drawKey(QPainter& painter, const KeyDefinition& key, const KeyRenderCache& cache,
+                           KeyVisual visual) const
+{
+    painter.save();
+    painter.setTransform(cache.transform, true);
 
-    const qreal drawnWidth{ m_sceneRect.width() * scale };
-    const qreal drawnHeight{ m_sceneRect.height() * scale };
+    painter.setPen(QPen{ g_outlineColor, g_outlinePenWidth });
+    painter.setBrush(frameColorFor(visual));
+    painter.drawRoundedRect(cache.keyRect, cache.radius, cache.radius);
 
-    const qreal startX{ padding + (availableWidth - drawnWidth) / 2.0 };
-    const qreal startY{ padding + (availableHeight - drawnHeight) / 2.0 };
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(faceColorFor(visual));
+    painter.drawRoundedRect(cache.face, cache.faceRadius, cache.faceRadius);
 
-    const qreal offsetX{ startX - m_sceneRect.x() * scale };
-    const qreal offsetY{ startY - m_sceneRect.y() * scale };
+    painter.setPen(g_labelColor);
+    if (cache.lines.size() == 2)
+    {
+        painter.setFont(cache.smallFont);
+        painter.drawText(cache.inner, Qt::AlignLeft | Qt::AlignTop, cache.lines[0]);
 
-    const qreal gap{ std::max<qreal>(1.5, scale * 0.04) };
-    const qreal frameInset{ std::max<qreal>(2.0, scale * 0.03) };
-    const qreal faceInset{ std::max<qreal>(3.0, scale * 0.05) };
+        painter.setFont(cache.font);
+        painter.drawText(cache.inner, Qt::AlignLeft | Qt::AlignBottom, cache.lines[1]);
+    }
+    else
+    {
+        painter.setFont(cache.font);
+        painter.drawText(cache.inner, Qt::AlignCenter, key.label);
+    }
 
-    const QColor frameColor{ 55, 58, 60 };
-    const QColor faceColor{ 25, 28, 30 };
-    const QColor framePressed{ 139, 0, 0 };
-    const QColor facePressed{ 178, 34, 34 };
-    const QColor frameTested{ 40, 60, 60 };
-    const QColor faceTested{ 30, 50, 50 };
-    const QColor outline{ 160, 150, 130 };
-    const QColor labelColor{ 240, 240, 240 };
+    painter.restore();
+}
 
-    for (const auto& key : m_keys)
+KeyboardView::KeyVisual KeyboardView::visualFor(std::size_t keyIndex) const
+{
+    const auto keyId{ m_keyIds[keyIndex] };
+    if (m_pressedKeys[keyId])
     {
-        painter.save();
-
-        const qreal rxScreen{ offsetX + key.rx * scale };
-        const qreal ryScreen{ offsetY + key.ry * scale };
+        return KeyVisual::pressed;
+    }
+    if (m_chatter.isChattering(m_scanIds[keyIndex]))
+    {
+        return KeyVisual::chattering;
+    }
+    return m_testedKeys[keyId] ? KeyVisual::tested : KeyVisual::idle;
+}
 
-        painter.translate(rxScreen, ryScreen);
-        painter.rotate(key.rotation);
+QColor KeyboardView::frameColorFor(KeyVisual visual)
+{
+    switch (visual)
+    {
+    case KeyVisual::pressed:
+        return QColor{ 139, 0, 0 };
+    case KeyVisual::tested:
+        return QColor{ 40, 60, 60 };
+    case KeyVisual::chattering:
+        return QColor{ 150, 100, 0 };
+    case KeyVisual::idle:
+        break;
+    }
+    return QColor{ 55, 58, 60 };
+}
 
-        QRectF keyRect{};
-        keyRect.setX((key.unitRect.x() - key.rx) * scale);
-        keyRect.setY((key.unitRect.y() - key.ry) * scale);
-        keyRect.setWidth(key.unitRect.width() * scale);
-        keyRect.setHeight(key.unitRect.height() * scale);
+QColor KeyboardView::faceColorFor(KeyVisual visual)
+{
+    switch (visual)
+    {
+    case KeyVisual::pressed:
+        return QColor{ 178, 34, 34 };
+    case KeyVisual::tested:
+        return QColor{ 30, 50, 50 };
+    case KeyVisual::chattering:
+        return QColor{ 200, 140, 20 };
+    case KeyVisual::idle:
+        break;
+    }
+    return QColor{ 25, 28, 30 };
+}
 
-        keyRect = keyRect.adjusted(gap, gap, -gap, -gap);
+KeyboardView::SceneMapping KeyboardView::sceneMapping() const
+{
+    const qreal availableWidth{ width() - 2.0 * g_viewPadding };
+    const qreal availableHeight{ height() - 2.0 * g_viewPadding };
 
-        const bool pressed{ isPressed(key) };
-        const auto keyId{ m_mode == KeyIdMode::virtualKey ? key.virtualKey : key.scanCode };
-        const bool tested{ !pressed && m_testedKeys.contains(keyId) };
+    const qreal scaleX{ availableWidth / m_sceneRect.width() };
+    const qreal scaleY{ availableHeight / m_sceneRect.height() };
+    const qreal scale{ std::min(scaleX, scaleY) };
 
-        const qreal radius{ std::min<qreal>(g_keyCornerRadius, std::min(keyRect.width(), keyRect.height()) * 0.18) };
+    const qreal drawnWidth{ m_sceneRect.width() * scale };
+    const qreal drawnHeight{ m_sceneRect.height() * scale };
 
-        painter.setPen(QPen{ outline, g_outlinePenWidth });
-        painter.setBrush(pressed ? framePressed : (tested ? frameTested : frameColor));
-        painter.drawRoundedRect(keyRect, radius, radius);
+    const qreal startX{ g_viewPadding + (availableWidth - drawnWidth) / 2.0 };
+    const qreal startY{ g_viewPadding + (availableHeight - drawnHeight) / 2.0 };
 
-        QRectF face{ keyRect.adjusted(faceInset, faceInset, -faceInset, -faceInset) };
-        const qreal faceRadius{ std::max<qreal>(0.0, radius - 2.0) };
+    return SceneMapping{ scale, startX - m_sceneRect.x() * scale, startY - m_sceneRect.y() * scale };
+}
 
-        painter.setPen(Qt::NoPen);
-        painter.setBrush(pressed ? facePressed : (tested ? faceTested : faceColor));
-        painter.drawRoundedRect(face, faceRadius, faceRadius);
+// Key outline relative to its rotation origin, inset by the gap between keys.
+QRectF KeyboardView::keyRectAt(const KeyDefinition& key, qreal scale) const
+{
+    const qreal gap{ std::max<qreal>(1.5, scale * 0.04) };
+    QRectF keyRect{};
+    keyRect.setX((key.unitRect.x() - key.rx) * scale);
+    keyRect.setY((key.unitRect.y() - key.ry) * scale);
+    keyRect.setWidth(key.unitRect.width() * scale);
+    keyRect.setHeight(key.unitRect.height() * scale);
+    return keyRect.adjusted(gap, gap, -gap, -gap);
+}
 
-        painter.setPen(labelColor);
+void KeyboardView::rebuildRenderCache()
+{
+    m_renderCache.clear();
+    if (m_keys.empty() || m_sceneRect.isEmpty())
+    {
+        return;
+    }
 
-        const QStringList lines{ key.label.split('\n') };
-        QRectF inner{ face.adjusted(frameInset, frameInset, -frameInset, -frameInset) };
+    const auto mapping{ sceneMapping() };
+    const qreal scale{ mapping.scale };
+    m_spritePixelRatio = devicePixelRatioF();
+    const qreal frameInset{ std::max<qreal>(2.0, scale * 0.03) };
+    const qreal faceInset{ std::max<qreal>(3.0, scale * 0.05) };
 
-        if (lines.size() == 2)
+    m_renderCache.resize(m_keys.size());
+    for (std::size_t index{ 0 }; index < m_keys.size(); ++index)
+    {
+        const auto& key{ m_keys[index] };
+        auto& cache{ m_renderCache[index] };
+
+        cache.transform.translate(mapping.offsetX + key.rx * scale, mapping.offsetY + key.ry * scale);
+        cache.transform.rotate(key.rotation);
+        cache.keyRect = keyRectAt(key, scale);
+        const QRect bounds{ cache.transform.map(QPolygonF{ cache.keyRect }).boundingRect().toAlignedRect() };
+        cache.screenRect = bounds.adjusted(-g_dirtyMargin, -g_dirtyMargin, g_dirtyMargin, g_dirtyMargin);
+
+        cache.radius =
+            std::min<qreal>(g_keyCornerRadius, std::min(cache.keyRect.width(), cache.keyRect.height()) * 0.18);
+        cache.face = cache.keyRect.adjusted(faceInset, faceInset, -faceInset, -faceInset);
+        cache.faceRadius = std::max<qreal>(0.0, cache.radius - 2.0);
+        cache.inner = cache.face.adjusted(frameInset, frameInset, -frameInset, -frameInset);
+
+        cache.lines = key.label.split('\n');
+        cache.font = font();
+        if (cache.lines.size() == 2)
         {
-            QFont base{ painter.font() };
-            base.setPointSizeF(std::max<qreal>(g_minFontSize, inner.height() * g_twoLineFontFactor));
-
-            QFont smallFont{ base };
-            smallFont.setPointSizeF(base.pointSizeF() * g_smallFontScale);
-
-            painter.setFont(smallFont);
-            painter.drawText(inner, Qt::AlignLeft | Qt::AlignTop, lines[0]);
-
-            painter.setFont(base);
-            painter.drawText(inner, Qt::AlignLeft | Qt::AlignBottom, lines[1]);
+            cache.font.setPointSizeF(std::max<qreal>(g_minFontSize, cache.inner.height() * g_twoLineFontFactor));
+            cache.smallFont = cache.font;
+            cache.smallFont.setPointSizeF(cache.font.pointSizeF() * g_smallFontScale);
         }
         else
         {
-            QFont f{ painter.font() };
-            qreal fontSize{ std::max<qreal>(g_minFontSize, inner.height() * g_oneLineFontFactor) };
-            f.setPointSizeF(fontSize);
+            qreal fontSize{ std::max<qreal>(g_minFontSize, cache.inner.height() * g_oneLineFontFactor) };
+            cache.font.setPointSizeF(fontSize);
 
-            const QFontMetricsF fm{ f };
+            const QFontMetricsF fm{ cache.font };
             const qreal textWidth{ fm.horizontalAdvance(key.label) };
-            const qreal maxWidth{ inner.width() * 0.9 };
-
+            const qreal maxWidth{ cache.inner.width() * 0.9 };
             if (textWidth > maxWidth && textWidth > 0.0)
             {
                 fontSize = std::max<qreal>(g_minScaledFontSize, fontSize * (maxWidth / textWidth));
-                f.setPointSizeF(fontSize);
+                cache.font.setPointSizeF(fontSize);
             }
+        }
 
-            painter.setFont(f);
-            painter.drawText(inner, Qt::AlignCenter, key.label);
+        if (m_spriteCache)
+        {
+            rasteriseSprites(key, cache);
         }
+    }
+}
+
+void KeyboardView::rasteriseSprites(const KeyDefinition& key, KeyRenderCache& cache) const
+{
+    const qreal pixelRatio{ m_spritePixelRatio };
+    for (std::size_t visual{ 0 }; visual < g_keyVisualCount; ++visual)
+    {
+        QPixmap sprite{ (QSizeF{ cache.screenRect.size() } * pixelRatio).toSize() };
+        sprite.setDevicePixelRatio(pixelRatio);
+        sprite.fill(Qt::transparent);
+
+        QPainter painter{ &sprite };
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        painter.translate(-cache.screenRect.topLeft());
+        drawKey(painter, key, cache, static_cast<KeyVisual>(visual));
+        painter.end();
 
-        painter.restore();
+        cache.sprites[visual] = sprite;
+    }
+}
+
+void KeyboardView::rebuildKeyLookup()
+{
+    // Counting sort of the key indices by id.
+    m_keyIds.resize(m_keys.size());
+    m_scanIds.resize(m_keys.size());
+    m_keyIndexOffsets.fill(0);
+    for (std::size_t index{ 0 }; index < m_keys.size(); ++index)
+    {
+        const auto& key{ m_keys[index] };
+        m_scanIds[index] = static_cast<std::uint16_t>(std::min<std::size_t>(key.scanCode, g_keyIdCount));
+        const auto keyId{ m_mode == KeyIdMode::virtualKey ? key.virtualKey : key.scanCode };
+        m_keyIds[index] = static_cast<std::uint16_t>(std::min<std::size_t>(keyId, g_keyIdCount));
+        if (m_keyIds[index] < g_keyIdCount)
+        {
+            ++m_keyIndexOffsets[m_keyIds[index] + 1];
+        }
+    }
+    for (std::size_t keyId{ 1 }; keyId < m_keyIndexOffsets.size(); ++keyId)
+    {
+        m_keyIndexOffsets[keyId] += m_keyIndexOffsets[keyId - 1];
+    }
+
+    m_keyIndices.resize(m_keyIndexOffsets.back());
+    auto next{ m_keyIndexOffsets };
+    for (std::size_t index{ 0 }; index < m_keys.size(); ++index)
+    {
+        if (m_keyIds[index] < g_keyIdCount)
+        {
+            m_keyIndices[next[m_keyIds[index]]++] = static_cast<std::uint16_t>(index);
+        }
+    }
+}
+
+void KeyboardView::invalidateKey(std::uint32_t keyId)
+{
+    // Without geometry yet (not laid out) there is nothing finer than a full repaint.
+    if (m_renderCache.size() != m_keys.size())
+    {
+        update();
+        return;
+    }
+    for (auto entry{ m_keyIndexOffsets[keyId] }; entry < m_keyIndexOffsets[keyId + 1]; ++entry)
+    {
+        update(m_renderCache[m_keyIndices[entry]].screenRect);
     }
 }
 
@@ -348,8 +613,11 @@ bool KeyboardView::loadLayoutFromFiles(const QString& geometryPath, const QStrin
 #endif
     }
 
-    m_pressedKeys.clear();
-    m_testedKeys.clear();
+    m_pressedKeys.reset();
+    m_testedKeys.reset();
+    m_chatter.reset();
+    rebuildRenderCache();
+    rebuildKeyLookup();
     update();
     return true;
 }
@@ -458,18 +726,17 @@ void KeyboardView::recalculateBounds()
     m_sceneRect = QRectF(minX, minY, maxX - minX, maxY - minY);
 }
 
-bool KeyboardView::isPressed(const KeyDefinition& key) const
-{
-    const auto keyId{ m_mode == KeyIdMode::virtualKey ? key.virtualKey : key.scanCode };
-    return m_pressedKeys.find(keyId) != m_pressedKeys.end();
-}
-
 std::uint32_t KeyboardView::keyIdForEvent(const inputTester::inputEvent& event) const
 {
     if (m_mode == KeyIdMode::virtualKey)
     {
         return event.virtualKey;
     }
+    return scanIdForEvent(event);
+}
+
+std::uint32_t KeyboardView::scanIdForEvent(const inputTester::inputEvent& event)
+{
     if (event.isExtended)
     {
         return event.scanCode + g_extendedKeyOffset;
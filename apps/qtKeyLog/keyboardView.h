@@ -1,15 +1,25 @@
 #ifndef inputTesterAppsKeyboardViewH
 #define inputTesterAppsKeyboardViewH
 
+#include <array>
+#include <bitset>
 #include <cstdint>
-#include <unordered_set>
 #include <vector>
 
+#include <QFont>
+#include <QPainter>
+#include <QPixmap>
+#include <QRect>
 #include <QRectF>
+#include <QRegion>
 #include <QString>
+#include <QStringList>
+#include <QTransform>
 #include <QWidget>
 
+#include "inputtester/core/chatterDetector.h"
 #include "inputtester/core/inputEvent.h"
+#include "inputtester/core/latencyTrace.h"
 
 class KeyboardView final : public QWidget
 {
@@ -24,18 +34,34 @@ public:
 
     void setKeyIdMode(KeyIdMode mode);
     KeyIdMode getKeyIdMode() const;
+    // For backends whose events carry no virtual key (evdev): switches to scan codes and keeps the view there,
+    // since every event would have id 0 in virtualKey mode.
+    void setVirtualKeysAvailable(bool available);
     void resetPressedKeys();
     void resetTestedKeys();
+    void resetChatter();
     std::size_t getPressedKeyCount() const;
+    // Keyed by scan code (plus the extended offset) whatever the id mode, so switching modes keeps the statistics.
+    const inputTester::chatterDetector& getChatterDetector() const;
 
     bool loadLayoutFromFiles(const QString& geometryPath, const QString& mappingPath, QString* errorMessage);
 
+    // Changed keys are collected rather than repainted; flushUpdates() invalidates them, once per frame.
     void handleInputEvent(const inputTester::inputEvent& event);
+    void flushUpdates();
+
+    // Optional; when set, every completed paint stamps latencyStage::painted. Not owned.
+    void setLatencyTrace(inputTester::latencyTrace* trace);
+
+    // Pre-rasterised keys turn each key repaint into one pixmap blit, at the cost of one pixmap per key and
+    // visual state. On by default; off draws the cached outlines and text directly.
+    void setSpriteCache(bool enabled);
 
     QSize sizeHint() const override;
 
 protected:
     void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
 
 private:
     struct KeyDefinition
@@ -49,20 +75,83 @@ private:
         qreal ry{};
     };
 
+    // Maps layout units to widget pixels: screen = offset + unit * scale.
+    struct SceneMapping
+    {
+        qreal scale{};
+        qreal offsetX{};
+        qreal offsetY{};
+    };
+
+    enum class KeyVisual : std::uint8_t
+    {
+        idle = 0,
+        pressed,
+        tested,
+        chattering,
+    };
+    static constexpr std::size_t g_keyVisualCount{ 4 };
+
+    // Everything a key's paint needs that depends only on the layout and the widget size.
+    struct KeyRenderCache
+    {
+        QTransform transform; // key rotation origin -> widget
+        QRect screenRect;     // widget-space bounds of the rotated key, plus room for the antialiased outline
+        QRectF keyRect;
+        QRectF face;
+        QRectF inner;
+        qreal radius{};
+        qreal faceRadius{};
+        QStringList lines;
+        QFont font;      // the label, or its second line
+        QFont smallFont; // first line of two-line labels
+        std::array<QPixmap, g_keyVisualCount> sprites; // screenRect-sized; null without the sprite cache
+    };
+
+    void paintKeyboard(const QRegion& region);
+    SceneMapping sceneMapping() const;
+    QRectF keyRectAt(const KeyDefinition& key, qreal scale) const;
+    void rebuildRenderCache();
+    void rasteriseSprites(const KeyDefinition& key, KeyRenderCache& cache) const;
+    void drawKey(QPainter& painter, const KeyDefinition& key, const KeyRenderCache& cache, KeyVisual visual) const;
+    KeyVisual visualFor(std::size_t keyIndex) const;
+    static QColor frameColorFor(KeyVisual visual);
+    static QColor faceColorFor(KeyVisual visual);
+    void rebuildKeyLookup();
+    void invalidateKey(std::uint32_t keyId);
     void recalculateBounds();
     void addKeyAt(qreal x, qreal y, qreal widthUnits, qreal heightUnits, const QString& label, std::uint32_t virtualKey,
                   std::uint32_t scanCode);
     bool loadKleGeometry(const QString& geometryPath, QString* errorMessage);
     bool applyMapping(const QString& mappingPath, QString* errorMessage);
 
-    bool isPressed(const KeyDefinition& key) const;
     std::uint32_t keyIdForEvent(const inputTester::inputEvent& event) const;
+    static std::uint32_t scanIdForEvent(const inputTester::inputEvent& event);
+    void markScanIdDirty(std::uint32_t scanId);
     std::vector<KeyDefinition> m_keys;
-    std::unordered_set<std::uint32_t> m_pressedKeys;
-    std::unordered_set<std::uint32_t> m_testedKeys;
+    // Parallel to m_keys; rebuilt on layout load, and by the first paint after a resize empties it.
+    std::vector<KeyRenderCache> m_renderCache;
+    bool m_spriteCache{ true };
+    qreal m_spritePixelRatio{}; // device pixel ratio the sprites were rasterised for
+    // Key ids in the current mode: VKs are at most 255 and scan codes plus the extended offset stay under 1024.
+    // Layout keys with an id outside that range map to the spare bit g_keyIdCount, which is never set.
+    static constexpr std::size_t g_keyIdCount{ 1'024 };
+    using KeyBits = std::bitset<g_keyIdCount + 1>;
+    // key id -> indices into m_keys, as m_keyIndices[m_keyIndexOffsets[id] .. m_keyIndexOffsets[id + 1]);
+    // several keys may share an id. Plus the id of each key. Rebuilt on layout load and id mode changes.
+    std::array<std::uint16_t, g_keyIdCount + 1> m_keyIndexOffsets{};
+    std::vector<std::uint16_t> m_keyIndices;
+    std::vector<std::uint16_t> m_keyIds;
+    std::vector<std::uint16_t> m_scanIds; // parallel to m_keys; the chatter detector's id, in either mode
+    KeyBits m_pressedKeys;
+    KeyBits m_testedKeys;
+    KeyBits m_dirtyKeys; // changed since the last flushUpdates()
+    inputTester::chatterDetector m_chatter;
 
     KeyIdMode m_mode{ KeyIdMode::virtualKey };
+    bool m_virtualKeysAvailable{ true };
     QRectF m_sceneRect;
+    inputTester::latencyTrace* m_latencyTrace{};
 };
 
 #endif // inputTesterAppsKeyboardViewH
@@ -1,48 +1,246 @@
-#include <deque>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <memory>
+#include <string>
+#include <thread>
+
+#if defined(__unix__)
+#include <time.h>
+#endif
 
 #include <QApplication>
 #include <QComboBox>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDir>
+#include <QFile>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QFontDatabase>
 #include <QHBoxLayout>
 #include <QIcon>
 #include <QLabel>
 #include <QMessageBox>
 #include <QPlainTextEdit>
 #include <QPushButton>
+#include <QScreen>
 #include <QSettings>
 #include <QSizePolicy>
+#include <QSocketNotifier>
 #include <QString>
+#include <QTextCursor>
+#include <QTextDocument>
 #include <QTextOption>
+#include <QTextStream>
 #include <QTimer>
 #include <QVBoxLayout>
 #include <QWidget>
 
+#include "inputtester/core/captureFile.h"
 #include "inputtester/core/inputEvent.h"
+#include "inputtester/core/inputEventMergeQueue.h"
 #include "inputtester/core/inputEventQueue.h"
+#include "inputtester/core/inputEventSink.h"
+#include "inputtester/core/inputEventTee.h"
+#include "inputtester/core/intervalHistogram.h"
+#include "inputtester/core/latencyTrace.h"
+#include "inputtester/core/pollingRateDetector.h"
+#include "inputtester/core/textRing.h"
 #include "inputtester/platform/inputBackend.h"
 #include "keyboardView.h"
 
+namespace
+{
+
+// Per lane; over two minutes of 8 kHz input. Every lane is allocated at startup, so this bounds the footprint.
+constexpr std::size_t g_maxQueueCapacity{ std::size_t{ 1 } << 20 };
+
+struct QueueOptions
+{
+    inputTester::overflowPolicy policy{ inputTester::overflowPolicy::dropNewest };
+    std::size_t capacity{ inputTester::inputEventQueue::defaultCapacity };
+    inputTester::ringMemoryOptions memory{};
+};
+
+inputTester::overflowPolicy overflowPolicyFromName(const QString& name)
+{
+    if (name == "overwriteOldest")
+    {
+        return inputTester::overflowPolicy::overwriteOldest;
+    }
+    if (name == "coalesceMotion")
+    {
+        return inputTester::overflowPolicy::coalesceMotion;
+    }
+    return inputTester::overflowPolicy::dropNewest;
+}
+
+std::size_t clampQueueCapacity(qulonglong requested, const char* source)
+{
+    if (requested <= g_maxQueueCapacity)
+    {
+        return static_cast<std::size_t>(requested);
+    }
+    qWarning().noquote() << source << requested << "exceeds the queue limit, using" << g_maxQueueCapacity;
+    return g_maxQueueCapacity;
+}
+
+// Settings provide the defaults; command line flags override them for a single run.
+QueueOptions loadQueueOptions(const QCommandLineParser& parser, const QCommandLineOption& capacityOption,
+                              const QCommandLineOption& lockOption, const QCommandLineOption& hugePagesOption)
+{
+    const QSettings settings{};
+    QueueOptions options{};
+    options.policy = overflowPolicyFromName(settings.value("queue/overflowPolicy").toString());
+
+    bool ok{ false };
+    const auto storedCapacity{ settings.value("queue/capacity").toULongLong(&ok) };
+    if (ok && storedCapacity != 0)
+    {
+        options.capacity = clampQueueCapacity(storedCapacity, "queue/capacity");
+    }
+    if (parser.isSet(capacityOption))
+    {
+        const auto flagCapacity{ parser.value(capacityOption).toULongLong(&ok) };
+        if (ok && flagCapacity != 0)
+        {
+            options.capacity = clampQueueCapacity(flagCapacity, "--queue-capacity");
+        }
+        else
+        {
+            qWarning().noquote() << "Ignoring invalid --queue-capacity:" << parser.value(capacityOption);
+        }
+    }
+
+    options.memory.lockPages = parser.isSet(lockOption) || settings.value("queue/lockMemory", false).toBool();
+    options.memory.hugePages = parser.isSet(hugePagesOption) || settings.value("queue/hugePages", false).toBool();
+    return options;
+}
+
+// CPU time consumed by the calling thread, or 0 where the platform has no per-thread clock.
+std::uint64_t threadCpuTimeNs()
+{
+#if defined(__unix__)
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<std::uint64_t>(now.tv_sec) * 1'000'000'000ULL + static_cast<std::uint64_t>(now.tv_nsec);
+#else
+    return 0;
+#endif
+}
+
+// Feeds the queue with key presses and releases at a fixed rate from its own thread (--synthetic-rate), so the
+// UI cost of high-rate input can be measured without an 8 kHz device.
+class SyntheticInputSource
+{
+public:
+    SyntheticInputSource(inputTester::inputEventSink& sink, std::uint32_t rateHz)
+        : m_sink{ sink }, m_period{ std::chrono::nanoseconds{ 1'000'000'000 / std::max<std::uint32_t>(rateHz, 1) } },
+          m_thread{ [this]() { run(); } }
+    {
+    }
+
+    ~SyntheticInputSource()
+    {
+        m_stop.store(true, std::memory_order_relaxed);
+        m_thread.join();
+    }
+
+    SyntheticInputSource(const SyntheticInputSource&) = delete;
+    SyntheticInputSource& operator=(const SyntheticInputSource&) = delete;
+
+private:
+    static constexpr std::uint32_t g_keyCount{ 16 };
+    // Falling further behind than this skips ahead instead of bursting to catch up.
+    static constexpr int g_maxLagPeriods{ 16 };
+
+    void run()
+    {
+        auto next{ std::chrono::steady_clock::now() };
+        for (std::uint32_t sequence = 0; !m_stop.load(std::memory_order_relaxed); ++sequence)
+        {
+            next += m_period;
+            std::this_thread::sleep_until(next);
+            const auto now{ std::chrono::steady_clock::now() };
+            if (now - next > g_maxLagPeriods * m_period)
+            {
+                next = now;
+            }
+
+            inputTester::inputEvent fallback{};
+            auto* event{ inputTester::reserveEvent(m_sink, fallback) };
+            if (event == nullptr)
+            {
+                continue;
+            }
+            const auto key{ (sequence / 2) % g_keyCount };
+            event->sourceTimestampNs = inputTester::nowTimestampNs();
+            event->receiveTimestampNs = event->sourceTimestampNs;
+            event->device = inputTester::deviceType::keyboard;
+            event->kind = sequence % 2 == 0 ? inputTester::eventKind::keyDown : inputTester::eventKind::keyUp;
+            event->virtualKey = 'A' + key;
+            event->scanCode = 0x10 + key;
+            inputTester::commitEvent(m_sink, fallback);
+        }
+    }
+
+    inputTester::inputEventSink& m_sink;
+    std::chrono::nanoseconds m_period;
+    std::atomic_bool m_stop{ false };
+    std::thread m_thread;
+};
+
+struct LatencyInterval
+{
+    const char* name;
+    inputTester::latencyStage from;
+    inputTester::latencyStage to;
+};
+
+// Rows of the latency panel: consecutive stages, then end to end.
+constexpr std::array<LatencyInterval, 6> g_latencyIntervals{ {
+    { "device -> backend", inputTester::latencyStage::source, inputTester::latencyStage::receive },
+    { "backend -> queue", inputTester::latencyStage::receive, inputTester::latencyStage::enqueue },
+    { "in queue", inputTester::latencyStage::enqueue, inputTester::latencyStage::dequeue },
+    { "view update", inputTester::latencyStage::dequeue, inputTester::latencyStage::handled },
+    { "until painted", inputTester::latencyStage::handled, inputTester::latencyStage::painted },
+    { "total", inputTester::latencyStage::source, inputTester::latencyStage::painted },
+} };
+
+} // namespace
+
 class KeyLogWindow final : public QWidget
 {
 public:
-    KeyLogWindow()
+    KeyLogWindow(const QueueOptions& queueOptions, bool useEvdev, bool traceLatency, std::uint32_t syntheticRateHz,
+                 const QString& capturePath)
         : m_textLabel{ new QPlainTextEdit{} }, m_modeCombo{ new QComboBox{} }, m_keyboard{ new KeyboardView{ this } },
-          m_eventTimer{ new QTimer{ this } }
+          m_eventTimer{ new QTimer{ this } }, m_publishTimer{ new QTimer{ this } },
+          m_eventQueue{ g_maxInputProducers, queueOptions.policy, queueOptions.capacity, queueOptions.memory }
     {
         setWindowTitle("InputTester");
         resize(g_defaultWindowWidth, g_defaultWindowHeight);
         setFocusPolicy(Qt::StrongFocus);
+        if (queueOptions.memory.lockPages && !m_eventQueue.isMemoryLocked())
+        {
+            qWarning() << "Could not lock the input queue in RAM; raise RLIMIT_MEMLOCK to avoid page faults";
+        }
 
         auto* layout{ new QVBoxLayout{ this } }; // NOLINT(cppcoreguidelines-owning-memory)
         auto* modeLayout{ new QHBoxLayout{} };   // NOLINT(cppcoreguidelines-owning-memory)
         auto* modeLabel{ new QLabel{ "key id mode:" } };
 
-        m_modeCombo->addItem("virtualKey", static_cast<int>(KeyboardView::KeyIdMode::virtualKey));
+        // evdev events have scan codes only, so the view is pinned to them.
+        m_keyboard->setVirtualKeysAvailable(!useEvdev);
+        if (!useEvdev)
+        {
+            m_modeCombo->addItem("virtualKey", static_cast<int>(KeyboardView::KeyIdMode::virtualKey));
+        }
         m_modeCombo->addItem("scanCode", static_cast<int>(KeyboardView::KeyIdMode::scanCode));
         m_loadButton = new QPushButton{ "load layout" };               // NOLINT(cppcoreguidelines-owning-memory)
         m_resetButton = new QPushButton{ "reset keys" };               // NOLINT(cppcoreguidelines-owning-memory)
@@ -54,13 +252,15 @@ public:
         modeLayout->addWidget(m_layoutStatus);
         modeLayout->addStretch(1);
 
-        m_statsLabel = new QLabel{ "NKRO: 0 | Rate: 0 Hz" }; // NOLINT(cppcoreguidelines-owning-memory)
+        m_statsLabel = new QLabel{ "NKRO: 0\nKeyboard: - | Mouse: -" }; // NOLINT(cppcoreguidelines-owning-memory)
         QFont statsFont{ m_statsLabel->font() };
         statsFont.setBold(true);
         m_statsLabel->setFont(statsFont);
         m_infoLabel =                                                      // NOLINT(cppcoreguidelines-owning-memory)
             new QLabel{ "state=none dev=0 vKey=0 scan=0 repeat=0 ext=0" }; // NOLINT(cppcoreguidelines-owning-memory)
         m_textLabel->setReadOnly(true);
+        // The panel is edited in place every frame; an undo stack would grow without bound.
+        m_textLabel->setUndoRedoEnabled(false);
         m_textLabel->setLineWrapMode(QPlainTextEdit::WidgetWidth);
         m_textLabel->setWordWrapMode(QTextOption::WrapAnywhere);
         m_textLabel->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
@@ -73,16 +273,45 @@ public:
         layout->addWidget(m_statsLabel);
         layout->addWidget(m_infoLabel);
         layout->addWidget(m_textLabel);
+        if (traceLatency)
+        {
+            createLatencyPanel(layout);
+        }
         layout->addWidget(m_keyboard, 1);
 
+        const bool queueNotifies{ m_eventQueue.enableNotifications() };
+#if defined(__linux__)
+        m_backend = useEvdev ? inputTester::createEvdevInputBackend() : inputTester::createInputBackend();
+#else
         m_backend = inputTester::createInputBackend();
-        m_backend->setSink(&m_eventQueue);
+#endif
+        if (!capturePath.isEmpty())
+        {
+            startCapture(capturePath);
+        }
+        m_backend->setSink(inputSink());
         QString backendError{};
         const bool backendStarted{ m_backend->start(this, &backendError) };
 
         m_eventTimer->setInterval(g_timerIntervalMs);
         QObject::connect(m_eventTimer, &QTimer::timeout, this, &KeyLogWindow::drainEvents);
-        if (backendStarted)
+        m_publishTimer->setSingleShot(true);
+        m_publishTimer->setTimerType(Qt::PreciseTimer);
+        QObject::connect(m_publishTimer, &QTimer::timeout, this, &KeyLogWindow::publishFrame);
+        if (backendStarted && queueNotifies)
+        {
+            // Drain right after input arrives and sleep fully when idle; the timer is the fallback.
+            m_queueNotifier = new QSocketNotifier{ // NOLINT(cppcoreguidelines-owning-memory)
+                static_cast<qintptr>(m_eventQueue.notificationHandle()), QSocketNotifier::Read, this
+            };
+            QObject::connect(m_queueNotifier, &QSocketNotifier::activated, this,
+                             [this]()
+                             {
+                                 m_eventQueue.acknowledgeNotification();
+                                 drainEvents();
+                             });
+        }
+        else if (backendStarted)
         {
             m_eventTimer->start();
         }
@@ -92,6 +321,11 @@ public:
             m_infoLabel->setText(QString("input: %1").arg(message));
             QMessageBox::critical(this, "Input backend error", message);
         }
+        if (backendStarted && syntheticRateHz != 0)
+        {
+            // Claims its own merge lane on the first event, next to the backend's.
+            m_syntheticInput = std::make_unique<SyntheticInputSource>(*inputSink(), syntheticRateHz);
+        }
 
         QObject::connect(m_modeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this,
                          [this](int index)
@@ -112,7 +346,24 @@ public:
                          {
                              m_keyboard->resetPressedKeys();
                              m_keyboard->resetTestedKeys();
+                             m_keyboard->resetChatter();
                              m_currentMaxKeys = 0;
+                             for (auto& meter : m_intervalMeters)
+                             {
+                                 meter.claimed = false;
+                                 meter.events = 0;
+                                 meter.lastTimestampNs = 0;
+                                 meter.histogram.reset();
+                                 meter.pollingRate.reset();
+                             }
+                             m_queueBaseline = m_eventQueue.counters();
+                             m_overrunBaseline = m_backend->overrunCount();
+                             if (m_latencyTrace)
+                             {
+                                 m_latencyTrace->reset();
+                                 updateLatencyPanel();
+                             }
+                             updateStats();
                          });
 
         QObject::connect(
@@ -176,57 +427,320 @@ public:
 
     ~KeyLogWindow() override
     {
+        m_syntheticInput.reset();
         if (m_backend)
         {
             m_backend->stop();
         }
+        std::string captureError{};
+        if (m_captureWriter && !m_captureWriter->close(&captureError))
+        {
+            qWarning().noquote() << "Capture incomplete:" << QString::fromStdString(captureError);
+        }
     }
 
 private:
     static constexpr int g_defaultWindowWidth{ 980 };
     static constexpr int g_defaultWindowHeight{ 520 };
     static constexpr int g_timerIntervalMs{ 16 };
-    static constexpr int g_textBufferLimit{ 100 };
+    static constexpr std::size_t g_maxInputProducers{ 8 };
+    static constexpr std::size_t g_textBufferLimit{ 100 }; // code points
     static constexpr int g_textLabelHeight{ 64 };
-    static constexpr std::size_t g_timestampBufferSize{ 32 };
-    static constexpr double g_nanosecondsPerSecond{ 1'000'000'000.0 };
+    static constexpr double g_nanosecondsPerMicrosecond{ 1'000.0 };
+    static constexpr double g_nanosecondsPerMillisecond{ 1'000'000.0 };
+    // Longer pauses are idle time rather than report intervals and stay out of the histograms.
+    static constexpr std::uint64_t g_maxMeteredIntervalNs{ 1'000'000'000 };
+    // Devices metered separately; interleaving two devices' timestamps would corrupt both analyses. Later
+    // devices are not metered.
+    static constexpr std::size_t g_maxMeteredDevices{ 8 };
+    static constexpr double g_fallbackRefreshHz{ 60.0 };
+    // The UI CPU share is averaged over at least this long.
+    static constexpr std::uint64_t g_cpuSampleNs{ 1'000'000'000 };
+
+    // One per (deviceId, device) pair, claimed on the first event from it.
+    struct IntervalMeter
+    {
+        bool claimed{ false };
+        std::uint32_t deviceId{};
+        inputTester::deviceType device{ inputTester::deviceType::unknown };
+        std::uint64_t events{};
+        std::uint64_t lastTimestampNs{};
+        inputTester::intervalHistogram histogram;
+        inputTester::pollingRateDetector pollingRate;
+    };
+    static constexpr int g_latencyRefreshMs{ 500 };
+
+    // Stage stamps cost a few clock reads per event, so tracing is only set up when asked for. Runs before the
+    // backend starts so the queue's producer side sees the enqueue stamps from the first event.
+    void createLatencyPanel(QVBoxLayout* layout)
+    {
+        m_latencyTrace = std::make_unique<inputTester::latencyTrace>();
+        // Unavailable under overwriteOldest; the queue stage then simply stays empty.
+        m_eventQueue.enableEnqueueStamps();
+        m_keyboard->setLatencyTrace(m_latencyTrace.get());
+
+        auto* panelLayout{ new QHBoxLayout{} }; // NOLINT(cppcoreguidelines-owning-memory)
+        m_latencyLabel = new QLabel{};           // NOLINT(cppcoreguidelines-owning-memory)
+        m_latencyLabel->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+        m_latencyLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+        auto* exportButton{ new QPushButton{ "export latency" } }; // NOLINT(cppcoreguidelines-owning-memory)
+        panelLayout->addWidget(m_latencyLabel, 1);
+        panelLayout->addWidget(exportButton, 0, Qt::AlignTop);
+        layout->addLayout(panelLayout);
+
+        QObject::connect(exportButton, &QPushButton::clicked, this, &KeyLogWindow::exportLatency);
+        auto* refreshTimer{ new QTimer{ this } }; // NOLINT(cppcoreguidelines-owning-memory)
+        refreshTimer->setInterval(g_latencyRefreshMs);
+        QObject::connect(refreshTimer, &QTimer::timeout, this, &KeyLogWindow::updateLatencyPanel);
+        refreshTimer->start();
+        updateLatencyPanel();
+    }
+
+    static double microseconds(std::uint64_t nanoseconds)
+    {
+        return static_cast<double>(nanoseconds) / g_nanosecondsPerMicrosecond;
+    }
 
+    void updateLatencyPanel()
+    {
+        QString text{ QString("%1%2%3%4%5")
+                          .arg(QString("latency (us), last %1").arg(m_latencyTrace->capacity()), -28)
+                          .arg("p50", 10)
+                          .arg("p99", 10)
+                          .arg("max", 10)
+                          .arg("n", 8) };
+        for (const auto& interval : g_latencyIntervals)
+        {
+            const auto summary{ m_latencyTrace->summarize(interval.from, interval.to) };
+            text += QString("\n%1%2%3%4%5")
+                        .arg(interval.name, -28)
+                        .arg(microseconds(summary.p50Ns), 10, 'f', 1)
+                        .arg(microseconds(summary.p99Ns), 10, 'f', 1)
+                        .arg(microseconds(summary.maxNs), 10, 'f', 1)
+                        .arg(summary.count, 8);
+        }
+        m_latencyLabel->setText(text);
+    }
+
+    // Summary rows as '#' comments, then one CSV row of raw stage stamps per retained event.
+    void exportLatency()
+    {
+        const auto path{ QFileDialog::getSaveFileName(this, "Export latency trace", "latency.csv", "CSV (*.csv)") };
+        if (path.isEmpty())
+        {
+            return;
+        }
+        QFile file{ path };
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        {
+            QMessageBox::warning(this, "Latency export failed", file.errorString());
+            return;
+        }
+
+        QTextStream out{ &file };
+        out << "# interval,from,to,count,p50_ns,p99_ns,max_ns\n";
+        for (const auto& interval : g_latencyIntervals)
+        {
+            const auto summary{ m_latencyTrace->summarize(interval.from, interval.to) };
+            out << "# " << interval.name << ',' << inputTester::latencyTrace::stageName(interval.from) << ','
+                << inputTester::latencyTrace::stageName(interval.to) << ',' << summary.count << ',' << summary.p50Ns
+                << ',' << summary.p99Ns << ',' << summary.maxNs << '\n';
+        }
+        out << "sequence";
+        for (std::size_t stage{ 0 }; stage < inputTester::latencyStageCount; ++stage)
+        {
+            out << ',' << inputTester::latencyTrace::stageName(static_cast<inputTester::latencyStage>(stage)) << "_ns";
+        }
+        out << '\n';
+        m_latencyTrace->forEachRecord(
+            [&out](std::uint64_t sequence, const inputTester::latencyTrace::stageStamps& stamps)
+            {
+                out << sequence;
+                for (const auto stampNs : stamps)
+                {
+                    out << ',' << stampNs;
+                }
+                out << '\n';
+            });
+    }
+
+    // Drains only fold events into state; what they change on screen is published at most once per display
+    // frame, so an 8 kHz burst formats the labels and repaints the keys once rather than per event.
     void drainEvents()
     {
-        inputTester::inputEvent event{};
-        while (m_eventQueue.tryPop(event))
+        const auto drained{ m_eventQueue.drain([this](const inputTester::inputEvent& event) { handleEvent(event); }) };
+
+        if (drained != 0)
+        {
+            schedulePublish();
+        }
+    }
+
+    // The first change after an idle period goes out right away; later ones wait for the next frame slot.
+    void schedulePublish()
+    {
+        if (m_publishTimer->isActive())
+        {
+            return;
+        }
+        const auto sinceLastNs{ static_cast<double>(inputTester::nowTimestampNs() - m_lastPublishNs) };
+        const auto waitNs{ std::max(0.0, frameIntervalNs() - sinceLastNs) };
+        m_publishTimer->start(static_cast<int>(std::ceil(waitNs / g_nanosecondsPerMillisecond)));
+    }
+
+    double frameIntervalNs() const
+    {
+        const auto* currentScreen{ screen() };
+        const auto refreshHz{ currentScreen != nullptr && currentScreen->refreshRate() > 0.0
+                                  ? currentScreen->refreshRate()
+                                  : g_fallbackRefreshHz };
+        return 1'000'000'000.0 / refreshHz;
+    }
+
+    void publishFrame()
+    {
+        m_lastPublishNs = inputTester::nowTimestampNs();
+        if (m_infoDirty)
+        {
+            updateInfo(m_lastInfoEvent);
+            m_infoDirty = false;
+        }
+        if (m_typedText.hasPendingChanges())
+        {
+            publishTypedText();
+        }
+        m_keyboard->flushUpdates();
+        updateStats();
+    }
+
+    void handleEvent(const inputTester::inputEvent& event)
+    {
+        // Only key events reach pixels; text and mouse events would wait for an unrelated paint.
+        const bool traced{ m_latencyTrace && event.device == inputTester::deviceType::keyboard &&
+                           !event.isTextEvent };
+        std::uint64_t traceSequence{ 0 };
+        if (traced)
+        {
+            traceSequence = m_latencyTrace->begin(event, m_eventQueue.lastEnqueueTimestampNs(),
+                                                  inputTester::nowTimestampNs());
+        }
+
+        if (!event.isTextEvent)
+        {
+            m_lastInfoEvent = event;
+            m_infoDirty = true;
+        }
+        if (event.kind == inputTester::eventKind::keyDown && event.text != U'\0')
+        {
+            handleText(event.text);
+        }
+
+        if (!event.isTextEvent && event.device != inputTester::deviceType::unknown)
+        {
+            recordInterval(event);
+        }
+
+        m_keyboard->handleInputEvent(event);
+        if (traced)
+        {
+            m_latencyTrace->stamp(traceSequence, inputTester::latencyStage::handled, inputTester::nowTimestampNs());
+        }
+
+        const auto currentKeys{ m_keyboard->getPressedKeyCount() };
+        if (currentKeys > m_currentMaxKeys)
+        {
+            m_currentMaxKeys = currentKeys;
+        }
+    }
+
+    IntervalMeter* meterFor(const inputTester::inputEvent& event)
+    {
+        for (auto& meter : m_intervalMeters)
         {
-            if (!event.isTextEvent)
+            if (!meter.claimed)
             {
-                updateInfo(event);
+                meter.claimed = true;
+                meter.deviceId = event.deviceId;
+                meter.device = event.device;
+                return &meter;
             }
-            if (event.kind == inputTester::eventKind::keyDown && event.text != U'\0')
+            if (meter.deviceId == event.deviceId && meter.device == event.device)
             {
-                handleText(event.text);
+                return &meter;
             }
+        }
+        return nullptr;
+    }
 
-            if (event.device == inputTester::deviceType::keyboard)
+    void recordInterval(const inputTester::inputEvent& event)
+    {
+        auto* found{ meterFor(event) };
+        if (found == nullptr)
+        {
+            return;
+        }
+        auto& meter{ *found };
+        ++meter.events;
+        meter.pollingRate.record(event.sourceTimestampNs);
+        // Changes reported in the same poll share a timestamp and are not an interval of their own.
+        if (meter.lastTimestampNs != 0 && event.sourceTimestampNs > meter.lastTimestampNs &&
+            event.sourceTimestampNs - meter.lastTimestampNs <= g_maxMeteredIntervalNs)
+        {
+            meter.histogram.record(event.sourceTimestampNs - meter.lastTimestampNs);
+        }
+        meter.lastTimestampNs = std::max(meter.lastTimestampNs, event.sourceTimestampNs);
+    }
+
+    // The device of this type that has sent the most events, or an empty meter if none has.
+    const IntervalMeter& busiestMeter(inputTester::deviceType device) const
+    {
+        static const IntervalMeter none{};
+        const IntervalMeter* busiest{ &none };
+        for (const auto& meter : m_intervalMeters)
+        {
+            if (meter.claimed && meter.device == device && meter.events > busiest->events)
             {
-                m_timestampBuffer.push_back(event.timestampNs);
-                if (m_timestampBuffer.size() > g_timestampBufferSize)
-                {
-                    m_timestampBuffer.pop_front();
-                }
+                busiest = &meter;
             }
+        }
+        return *busiest;
+    }
 
-            m_keyboard->handleInputEvent(event);
+    static QString meterName(const QString& name, const IntervalMeter& meter)
+    {
+        return meter.claimed ? QString("%1 (dev %2)").arg(name).arg(meter.deviceId) : name;
+    }
 
-            const auto currentKeys{ m_keyboard->getPressedKeyCount() };
-            if (currentKeys > m_currentMaxKeys)
-            {
-                m_currentMaxKeys = currentKeys;
-            }
+    static QString formatPollingRate(const QString& name, const inputTester::pollingRateDetector& detector)
+    {
+        const auto estimate{ detector.estimate() };
+        if (estimate.rateHz == 0)
+        {
+            return QString("%1 ?").arg(name);
         }
+        return QString("%1 %2 Hz (%3%, %4 missed)")
+            .arg(name)
+            .arg(estimate.rateHz)
+            .arg(qRound(estimate.confidence * 100.0))
+            .arg(estimate.missedPolls);
+    }
 
-        if (!m_timestampBuffer.empty())
+    static QString formatIntervals(const QString& name, const inputTester::intervalHistogram& histogram)
+    {
+        const auto summary{ histogram.summarize() };
+        if (summary.count == 0)
         {
-            updateStats();
+            return QString("%1: -").arg(name);
         }
+        const auto milliseconds{ [](double ns) { return ns / g_nanosecondsPerMillisecond; } };
+        return QString("%1: %2 Hz (p1/p50/p99 %3/%4/%5 ms, jitter %6 ms, %7 outliers)")
+            .arg(name)
+            .arg(qRound(summary.rateHz))
+            .arg(milliseconds(static_cast<double>(summary.p1Ns)), 0, 'f', 3)
+            .arg(milliseconds(static_cast<double>(summary.p50Ns)), 0, 'f', 3)
+            .arg(milliseconds(static_cast<double>(summary.p99Ns)), 0, 'f', 3)
+            .arg(milliseconds(summary.jitterNs), 0, 'f', 3)
+            .arg(summary.outliers);
     }
 
     void updateInfo(const inputTester::inputEvent& event)
@@ -243,42 +757,153 @@ private:
 
     void updateStats()
     {
-        int hz{ 0 };
-        if (m_timestampBuffer.size() >= 2)
+        const auto counters{ m_eventQueue.counters() };
+        const auto dropped{ counters.dropped - m_queueBaseline.dropped };
+        // Input the device or kernel lost before the backend read it, e.g. an evdev buffer overrun.
+        const auto overruns{ m_backend->overrunCount() - m_overrunBaseline };
+        const QString queueStats{ QString("Queue: %1 in, %2 dropped%3%4, %5 coalesced, peak %6/%7%8")
+                                      .arg(counters.enqueued - m_queueBaseline.enqueued)
+                                      .arg(dropped)
+                                      .arg(overruns != 0 ? QString(", %1 device overruns").arg(overruns) : QString{})
+                                      .arg(dropped != 0 || overruns != 0 ? " (measurement lossy)" : "")
+                                      .arg(counters.coalesced - m_queueBaseline.coalesced)
+                                      .arg(counters.highWaterMark)
+                                      .arg(m_eventQueue.capacity())
+                                      .arg(m_eventQueue.isMemoryLocked() ? " locked" : "") };
+        const auto& keyboard{ busiestMeter(inputTester::deviceType::keyboard) };
+        const auto& mouse{ busiestMeter(inputTester::deviceType::mouse) };
+        const auto pollingRates{ QString("Poll: %1, %2")
+                                     .arg(formatPollingRate(meterName("keyboard", keyboard), keyboard.pollingRate),
+                                          formatPollingRate(meterName("mouse", mouse), mouse.pollingRate)) };
+        const auto& chatter{ m_keyboard->getChatterDetector() };
+        const auto chatterStats{ QString("Chatter: %1 bounces on %2 keys")
+                                     .arg(chatter.totalBounces())
+                                     .arg(chatter.chatteringKeyCount()) };
+        m_statsLabel->setText(QString("NKRO: %1 (Max) | %2 | %3 | %4\n%5 | %6%7")
+                                  .arg(m_currentMaxKeys)
+                                  .arg(chatterStats, pollingRates, queueStats,
+                                       formatIntervals(meterName("Keyboard", keyboard), keyboard.histogram),
+                                       formatIntervals(meterName("Mouse", mouse), mouse.histogram),
+                                       uiCpuStats() + captureStats()));
+    }
+
+    // Producers feed the UI queue, and the capture writer too while a capture is being recorded.
+    inputTester::inputEventSink* inputSink()
+    {
+        if (m_captureTee)
         {
-            const auto duration{ m_timestampBuffer.back() - m_timestampBuffer.front() };
-            const auto count{ m_timestampBuffer.size() - 1 };
-            if (duration > 0)
-            {
-                hz = static_cast<int>(g_nanosecondsPerSecond * static_cast<double>(count) /
-                                      static_cast<double>(duration));
-            }
+            return m_captureTee.get();
         }
-        m_statsLabel->setText(QString("NKRO: %1 (Max) | Rate: %2 Hz").arg(m_currentMaxKeys).arg(hz));
+        return &m_eventQueue;
+    }
+
+    void startCapture(const QString& path)
+    {
+        std::string error{};
+        // The writer's queue lanes and block buffers take tens of MiB, so only a capture session builds one.
+        auto writer{ std::make_unique<inputTester::captureWriter>() };
+        if (!writer->open(path.toStdString(), &error))
+        {
+            QMessageBox::warning(this, "Capture not started", QString::fromStdString(error));
+            return;
+        }
+        m_captureWriter = std::move(writer);
+        m_captureTee = std::make_unique<inputTester::inputEventTee>(m_eventQueue, *m_captureWriter);
+    }
+
+    QString captureStats() const
+    {
+        if (!m_captureTee)
+        {
+            return {};
+        }
+        const auto stats{ m_captureWriter->stats() };
+        if (stats.failed)
+        {
+            return " | Capture: write failed";
+        }
+        const auto* backend{ stats.backend == inputTester::blockWriterBackend::ioUring ? "io_uring" : "thread" };
+        return QString(" | Capture (%1): %2 events, %3 MiB, %4 KiB/s, %5 dropped, %6 stalls")
+            .arg(backend)
+            .arg(stats.eventsWritten)
+            .arg(static_cast<double>(stats.bytesWritten) / (1024.0 * 1024.0), 0, 'f', 1)
+            .arg(stats.bytesPerSecond / 1024.0, 0, 'f', 0)
+            .arg(stats.dropped)
+            .arg(stats.stalls);
+    }
+
+    // Share of one core the UI thread used over the last sample period; empty without a thread CPU clock.
+    QString uiCpuStats()
+    {
+        const auto wallNs{ inputTester::nowTimestampNs() };
+        const auto cpuNs{ threadCpuTimeNs() };
+        if (cpuNs == 0)
+        {
+            return {};
+        }
+        if (m_cpuSampleWallNs == 0)
+        {
+            m_cpuSampleWallNs = wallNs;
+            m_cpuSampleCpuNs = cpuNs;
+        }
+        else if (wallNs - m_cpuSampleWallNs >= g_cpuSampleNs)
+        {
+            m_uiCpuPercent = 100.0 * static_cast<double>(cpuNs - m_cpuSampleCpuNs) /
+                             static_cast<double>(wallNs - m_cpuSampleWallNs);
+            m_cpuSampleWallNs = wallNs;
+            m_cpuSampleCpuNs = cpuNs;
+        }
+        return QString(" | UI CPU: %1%").arg(m_uiCpuPercent, 0, 'f', 1);
     }
 
     void handleText(char32_t text)
     {
         if (text == U'\b')
         {
-            if (!m_textBuffer.isEmpty())
-            {
-                m_textBuffer.chop(1);
-            }
+            m_typedText.backspace();
         }
-        else if (text == U'\n')
+        else
         {
-            m_textBuffer += QLatin1Char{ '\n' };
+            m_typedText.push(text);
         }
-        else
+    }
+
+    // Edits the panel's document by what changed since the last frame instead of re-setting all of it, so the
+    // cost follows the characters typed rather than the size of the buffer. Document positions count UTF-16
+    // units, with one per line break, which is what the ring's delta is measured in.
+    void publishTypedText()
+    {
+        const auto delta{ m_typedText.takeDelta() };
+        auto* document{ m_textLabel->document() };
+        QTextCursor cursor{ document };
+        cursor.beginEditBlock();
+        if (delta.removeFrontUnits != 0)
+        {
+            cursor.setPosition(0);
+            cursor.setPosition(static_cast<int>(delta.removeFrontUnits), QTextCursor::KeepAnchor);
+            cursor.removeSelectedText();
+        }
+        if (delta.removeBackUnits != 0)
         {
-            m_textBuffer += QString::fromUcs4(&text, 1);
+            // characterCount() includes the document's final paragraph separator.
+            const auto end{ document->characterCount() - 1 };
+            cursor.setPosition(end - static_cast<int>(delta.removeBackUnits));
+            cursor.setPosition(end, QTextCursor::KeepAnchor);
+            cursor.removeSelectedText();
         }
-        if (m_textBuffer.size() > g_textBufferLimit)
+        if (delta.appendFrom < m_typedText.size())
         {
-            m_textBuffer = m_textBuffer.right(g_textBufferLimit);
+            QString appended{};
+            appended.reserve(static_cast<qsizetype>(2 * (m_typedText.size() - delta.appendFrom)));
+            for (auto index = delta.appendFrom; index < m_typedText.size(); ++index)
+            {
+                const auto codePoint{ m_typedText.at(index) };
+                appended += QString::fromUcs4(&codePoint, 1);
+            }
+            cursor.movePosition(QTextCursor::End);
+            cursor.insertText(appended);
         }
-        m_textLabel->setPlainText(m_textBuffer);
+        cursor.endEditBlock();
     }
 
     void loadDefaultLayout()
@@ -312,12 +937,27 @@ private:
     QPushButton* m_loadButton{};
     QPushButton* m_resetButton{};
     QLabel* m_layoutStatus{};
-    QString m_textBuffer;
+    QLabel* m_latencyLabel{};
+    inputTester::textRing m_typedText{ g_textBufferLimit };
     QTimer* m_eventTimer{};
-    inputTester::inputEventQueue m_eventQueue{};
+    QTimer* m_publishTimer{};
+    QSocketNotifier* m_queueNotifier{};
+    inputTester::inputEventMergeQueue m_eventQueue;
+    inputTester::inputEventQueueCounters m_queueBaseline{};
+    std::uint64_t m_overrunBaseline{};
+    std::unique_ptr<inputTester::captureWriter> m_captureWriter; // only with --capture
+    std::unique_ptr<inputTester::inputEventTee> m_captureTee;
     std::unique_ptr<inputTester::inputBackend> m_backend;
+    std::unique_ptr<inputTester::latencyTrace> m_latencyTrace;
     std::size_t m_currentMaxKeys{ 0 };
-    std::deque<std::uint64_t> m_timestampBuffer;
+    std::array<IntervalMeter, g_maxMeteredDevices> m_intervalMeters{};
+    std::uint64_t m_lastPublishNs{};
+    inputTester::inputEvent m_lastInfoEvent{};
+    bool m_infoDirty{ false };
+    std::uint64_t m_cpuSampleWallNs{};
+    std::uint64_t m_cpuSampleCpuNs{};
+    double m_uiCpuPercent{};
+    std::unique_ptr<SyntheticInputSource> m_syntheticInput;
 };
 
 int main(int argc, char** argv)
@@ -327,7 +967,42 @@ int main(int argc, char** argv)
     QCoreApplication::setApplicationName("InputTester");
     QApplication::setWindowIcon(QIcon{ ":/inputtester/icons/InputTester.png" });
 
-    KeyLogWindow window{};
+    QCommandLineParser parser{};
+    parser.addHelpOption();
+    const QCommandLineOption capacityOption{
+        "queue-capacity", "Input queue size in events (rounded up to a power of two, at most 1048576).", "slots"
+    };
+    const QCommandLineOption lockOption{ "queue-lock-memory", "Lock the input queue pages in RAM (mlock)." };
+    const QCommandLineOption hugePagesOption{ "queue-huge-pages", "Back the input queue with huge pages." };
+    parser.addOption(capacityOption);
+    parser.addOption(lockOption);
+    parser.addOption(hugePagesOption);
+    const QCommandLineOption latencyOption{ "latency-trace",
+                                            "Stamp each key event at every pipeline stage and show a latency panel." };
+    parser.addOption(latencyOption);
+    const QCommandLineOption syntheticOption{
+        "synthetic-rate", "Also feed generated key presses at this rate, to measure UI cost under load.", "hz"
+    };
+    parser.addOption(syntheticOption);
+    const QCommandLineOption captureOption{ "capture", "Record every input event to a binary capture file.", "file" };
+    parser.addOption(captureOption);
+#if defined(__linux__)
+    const QCommandLineOption evdevOption{
+        "evdev", "Read keyboards and mice from /dev/input on a dedicated thread with kernel timestamps (no text input)."
+    };
+    parser.addOption(evdevOption);
+#endif
+    parser.process(app);
+
+#if defined(__linux__)
+    const bool useEvdev{ parser.isSet(evdevOption) };
+#else
+    const bool useEvdev{ false };
+#endif
+    const bool traceLatency{ parser.isSet(latencyOption) || QSettings{}.value("debug/latencyTrace", false).toBool() };
+    const auto syntheticRateHz{ parser.value(syntheticOption).toUInt() };
+    KeyLogWindow window{ loadQueueOptions(parser, capacityOption, lockOption, hugePagesOption), useEvdev,
+                         traceLatency, syntheticRateHz, parser.value(captureOption) };
     window.show();
 
     return QApplication::exec();
@@ -0,0 +1,66 @@
+# Compiles resources/linux_keymap.json into constexpr mapping arrays for linuxKeymapParser.cpp.
+# Run in script mode: cmake -DinputPath=<json> -DoutputPath=<header> -P generateLinuxKeymap.cmake
+# Qt key names are emitted as Qt::Key enumerators, so a misspelt name fails the C++ build rather than here.
+
+if (NOT inputPath OR NOT outputPath)
+    message(FATAL_ERROR "generateLinuxKeymap: inputPath and outputPath are required")
+endif()
+
+file(READ "${inputPath}" keymapJson)
+
+function(readJsonBool outVar object key)
+    string(JSON value ERROR_VARIABLE missing GET "${object}" "${key}")
+    if (missing OR NOT value)
+        set(${outVar} "false" PARENT_SCOPE)
+    else()
+        set(${outVar} "true" PARENT_SCOPE)
+    endif()
+endfunction()
+
+string(JSON nativeScanCodeOffset GET "${keymapJson}" nativeScanCodeOffset)
+
+set(qtKeyLines "")
+string(JSON qtKeyCount LENGTH "${keymapJson}" qtKeyToVirtualKey)
+math(EXPR qtKeyLast "${qtKeyCount} - 1")
+foreach (index RANGE ${qtKeyLast})
+    string(JSON entry GET "${keymapJson}" qtKeyToVirtualKey ${index})
+    string(JSON qtKey GET "${entry}" qtKey)
+    string(JSON virtualKey GET "${entry}" virtualKey)
+    readJsonBool(keypad "${entry}" keypad)
+    if (qtKey MATCHES "^Key_")
+        set(qtKey "Qt::${qtKey}")
+    endif()
+    string(APPEND qtKeyLines "    { ${qtKey}, ${keypad}, ${virtualKey} },\n")
+endforeach()
+
+set(scanLines "")
+string(JSON scanCount LENGTH "${keymapJson}" linuxScanToWinScan)
+math(EXPR scanLast "${scanCount} - 1")
+foreach (index RANGE ${scanLast})
+    string(JSON entry GET "${keymapJson}" linuxScanToWinScan ${index})
+    string(JSON linuxScanCode GET "${entry}" linuxScanCode)
+    string(JSON winScanCode GET "${entry}" winScanCode)
+    readJsonBool(extended "${entry}" extended)
+    string(APPEND scanLines "    { ${linuxScanCode}, ${winScanCode}, ${extended} },\n")
+endforeach()
+
+set(header "// Generated from linux_keymap.json by generateLinuxKeymap.cmake; do not edit.
+#include <QtCore/qnamespace.h>
+
+#include \"linuxKeymapParser.h\"
+
+namespace LinuxKeymapParser::generated
+{
+
+inline constexpr std::uint32_t g_nativeScanCodeOffset{ ${nativeScanCodeOffset} };
+
+inline constexpr QtKeyMapping g_qtKeyMappings[]{
+${qtKeyLines}};
+
+inline constexpr ScanMapping g_scanMappings[]{
+${scanLines}};
+
+} // namespace LinuxKeymapParser::generated
+")
+
+file(WRITE "${outputPath}" "${header}")
@@ -0,0 +1,155 @@
+#ifndef inputTesterCoreBlockWriterH
+#define inputTesterCoreBlockWriterH
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "inputtester/core/ringMemory.h"
+
+namespace inputTester
+{
+
+// Owning handle to a file opened for positional writes (a descriptor, or a HANDLE on Windows).
+class outputFile
+{
+public:
+    outputFile() = default;
+    ~outputFile();
+
+    outputFile(const outputFile&) = delete;
+    outputFile& operator=(const outputFile&) = delete;
+
+    // Creates or truncates path.
+    bool open(const std::string& path, std::string* errorMessage);
+    // Returns false (and leaves the reason in errorMessage) if the file could not be flushed and closed.
+    bool close(std::string* errorMessage = nullptr);
+
+    bool isOpen() const noexcept
+    {
+        return handle_ != invalidHandle;
+    }
+
+    // Blocking write of all bytes at offset.
+    bool writeAt(const void* data, std::size_t bytes, std::uint64_t offset, std::string* errorMessage);
+
+    std::intptr_t nativeHandle() const noexcept
+    {
+        return handle_;
+    }
+
+private:
+    static constexpr std::intptr_t invalidHandle{ -1 };
+
+    std::intptr_t handle_{ invalidHandle };
+};
+
+enum class blockWriterBackend : std::uint8_t
+{
+    thread = 0, // a worker thread issuing blocking positional writes
+    ioUring,    // Linux io_uring; nothing but submission and completion crosses into the kernel
+};
+
+struct blockWriterStats
+{
+    std::uint64_t bytesWritten{};  // completed writes
+    std::uint64_t blocksWritten{};
+    std::size_t inFlight{};        // blocks submitted but not yet written: the write queue depth
+    std::size_t peakInFlight{};
+    std::uint64_t stalls{};        // acquire() calls that had to wait for a buffer to come back
+    bool failed{ false };
+};
+
+// Asynchronous block writes to an outputFile from a fixed pool of block buffers. The producer acquires a buffer,
+// fills it and submits it at a file offset; the buffer comes back to the pool once the write completes. With two
+// or more buffers, filling the next block overlaps writing the previous one, and the producer only waits when
+// every buffer is still queued for the disk. All buffers are allocated up front, so steady-state writing
+// allocates nothing. One producer thread; stats() may be read from anywhere.
+class blockWriter
+{
+public:
+    virtual ~blockWriter();
+
+    blockWriter(const blockWriter&) = delete;
+    blockWriter& operator=(const blockWriter&) = delete;
+
+    // io_uring where requested and the kernel allows it, the worker thread otherwise. The file must outlive the
+    // writer.
+    static std::unique_ptr<blockWriter> create(outputFile& file, std::size_t blockBytes, std::size_t bufferCount,
+                                               blockWriterBackend preferred);
+
+    virtual blockWriterBackend backend() const noexcept = 0;
+
+    // A free, blockBytes-sized buffer. Waits for an in-flight write to finish if none is free.
+    std::span<std::byte> acquire();
+    // Writes the first bytes of a buffer returned by acquire() at offset. bytes may be 0 to hand the buffer back.
+    // Any other buffer is not written and fails the writer, which the next flush() reports.
+    void submit(std::span<std::byte> buffer, std::size_t bytes, std::uint64_t offset);
+    // Waits for every submitted write. Returns false if any of them failed.
+    bool flush(std::string* errorMessage = nullptr);
+
+    std::size_t blockBytes() const noexcept
+    {
+        return blockBytes_;
+    }
+
+    blockWriterStats stats() const;
+    // Clears the counters and any earlier failure, e.g. for a new file through the same pool. Call after flush().
+    void reset();
+
+protected:
+    blockWriter(outputFile& file, std::size_t blockBytes, std::size_t bufferCount);
+
+    // Starts writing buffer index; its completion is reported through completeWrite(), from any thread.
+    virtual void startWrite(std::size_t index, std::size_t bytes, std::uint64_t offset) = 0;
+    // Blocks until at least one write has completed since the previous call (or returns at once if one has).
+    virtual void waitForCompletion() = 0;
+    // Collects finished writes without blocking; the thread backend reports them as they happen instead.
+    virtual void pollCompletions()
+    {
+    }
+
+    // error is null for a write that completed in full.
+    void completeWrite(std::size_t index, std::size_t bytes, const char* error);
+
+    std::byte* bufferData(std::size_t index) const noexcept
+    {
+        return static_cast<std::byte*>(buffers_[index].data());
+    }
+
+    std::size_t bufferCount() const noexcept
+    {
+        return buffers_.size();
+    }
+
+    outputFile& file() noexcept
+    {
+        return file_;
+    }
+
+private:
+    bool takeFreeBuffer(std::size_t& index);
+    bool indexOf(std::span<std::byte> buffer, std::size_t& index) const;
+
+    outputFile& file_;
+    std::size_t blockBytes_;
+    std::vector<ringMemory> buffers_;
+    std::mutex poolMutex_; // free list and error; completions may arrive on the thread backend's worker
+    std::vector<std::size_t> freeBuffers_; // reserved for every buffer, so returning one never allocates
+    std::string error_;
+    std::atomic<std::uint64_t> bytesWritten_{};
+    std::atomic<std::uint64_t> blocksWritten_{};
+    std::atomic<std::size_t> inFlight_{};
+    std::atomic<std::size_t> peakInFlight_{};
+    std::atomic<std::uint64_t> stalls_{};
+    std::atomic_bool failed_{ false };
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCoreBlockWriterH
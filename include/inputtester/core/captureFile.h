@@ -0,0 +1,216 @@
+#ifndef inputTesterCoreCaptureFileH
+#define inputTesterCoreCaptureFileH
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+
+#include "inputtester/core/blockWriter.h"
+#include "inputtester/core/inputEvent.h"
+#include "inputtester/core/inputEventMergeQueue.h"
+#include "inputtester/core/inputEventSink.h"
+#include "inputtester/core/packedInputEvent.h"
+
+namespace inputTester
+{
+
+// Capture file layout, in host byte order (little-endian on every supported target):
+//   [0, recordsOffset)          captureFileHeader, zero padded to one page
+//   [recordsOffset, +slots*16)  packedInputEvent slots, exactly as the input queue stores them; source timestamps
+//                               are relative to epochNs and events that do not fit one slot are escaped
+//   [deviceTableOffset, ...)    deviceCount captureDeviceEntry records
+// The file is append-only while recording. The header's counts and the device table are written on close; a file
+// that was never closed (crash, power loss) still reads back, with the slot count taken from its size.
+struct captureFileHeader
+{
+    static constexpr std::array<char, 8> expectedMagic{ 'I', 'T', 'C', 'A', 'P', 'T', 'R', '\0' };
+    static constexpr std::uint32_t currentVersion{ 1 };
+    static constexpr std::uint64_t defaultRecordsOffset{ 4'096 };
+    static constexpr std::uint32_t completeFlag{ 1 };
+
+    std::array<char, 8> magic{ expectedMagic };
+    std::uint32_t version{ currentVersion };
+    std::uint32_t headerBytes{ sizeof(captureFileHeader) };
+    std::uint64_t recordsOffset{ defaultRecordsOffset };
+    std::uint64_t epochNs{};     // steady clock, the domain of every event timestamp
+    std::uint64_t wallClockNs{}; // system clock (Unix epoch) at epochNs, to place the capture in real time
+    std::uint64_t slotCount{};
+    std::uint64_t eventCount{};
+    std::uint64_t deviceTableOffset{};
+    std::uint32_t deviceCount{};
+    std::uint32_t flags{};
+};
+
+static_assert(sizeof(captureFileHeader) == 72);
+
+struct captureDeviceEntry
+{
+    std::uint32_t deviceId{};
+    deviceType device{ deviceType::unknown };
+    std::array<std::uint8_t, 3> reserved{};
+    std::uint64_t eventCount{};
+    std::uint64_t firstTimestampNs{};
+    std::uint64_t lastTimestampNs{};
+};
+
+static_assert(sizeof(captureDeviceEntry) == 32);
+
+struct captureWriterOptions
+{
+    std::size_t blockBytes{ 1U << 20 };       // write size; a multiple of the 4 KiB page
+    std::size_t blockCount{ 4 };              // block buffers: one being filled, the rest queued for the disk
+    blockWriterBackend backend{ blockWriterBackend::ioUring }; // falls back to a write thread where unavailable
+    std::size_t capacityPerLane{ 1U << 16 }; // slots buffered per producer thread, ~8 s of an 8 kHz device
+    std::size_t maxProducers{ inputEventMergeQueue::defaultMaxProducers };
+    std::chrono::milliseconds drainInterval{ 10 };
+};
+
+struct captureWriterStats
+{
+    std::uint64_t eventsWritten{};
+    std::uint64_t bytesWritten{};   // slots on disk, excluding the header and device table
+    double bytesPerSecond{};        // bytesWritten over the time since open()
+    std::uint64_t dropped{};        // events the capture queue had no room for
+    std::uint64_t queuedEventsPeak{}; // deepest producer lane of the capture queue, in slots
+    std::size_t blocksInFlight{};   // block writes queued or running
+    std::size_t blocksInFlightPeak{};
+    std::uint64_t stalls{};         // times the writer thread waited for a block buffer to come back
+    blockWriterBackend backend{ blockWriterBackend::thread };
+    bool failed{ false };           // a write failed; the recording stopped there
+};
+
+// Records a session to a capture file from a background thread. As an inputEventSink it only hands events to its
+// own merge queue, so producers never wait on the disk. The writer thread drains that queue every drainInterval
+// into block buffers from a small pool and hands full blocks to a blockWriter (io_uring, or a write thread), so
+// it keeps encoding while earlier blocks are written. Memory is fixed at construction however long the capture
+// runs. Events arriving while no file is open are ignored.
+class captureWriter final : public inputEventSink
+{
+public:
+    static constexpr std::size_t maxDevices{ 64 };
+
+    explicit captureWriter(captureWriterOptions options = {});
+    ~captureWriter() override;
+
+    captureWriter(const captureWriter&) = delete;
+    captureWriter& operator=(const captureWriter&) = delete;
+
+    // Creates (or truncates) path and starts the writer thread.
+    bool open(const std::string& path, std::string* errorMessage);
+    // Writes what is still queued, the device table and the final header. Returns false if any write failed.
+    bool close(std::string* errorMessage = nullptr);
+
+    bool isOpen() const noexcept
+    {
+        return open_.load(std::memory_order_acquire);
+    }
+
+    void onInputEvent(const inputEvent& event) override;
+    bool providesSlots() const noexcept override
+    {
+        return true;
+    }
+    inputEvent* reserveEvent() override;
+    void commitEvent() override;
+
+    captureWriterStats stats() const;
+
+private:
+    void run();
+    void drainQueue();
+    void appendSlot(const packedInputEvent& slot);
+    void submitBlock();
+    void recordDevice(const inputEvent& event);
+
+    captureWriterOptions options_;
+    inputEventMergeQueue queue_;
+    outputFile file_;
+    std::unique_ptr<blockWriter> blocks_;
+    std::span<std::byte> block_;   // the buffer being filled
+    std::size_t blockFill_{};      // bytes
+    std::uint64_t blockOffset_{};  // where block_ goes in the file
+    std::array<captureDeviceEntry, maxDevices> devices_{};
+    std::size_t deviceCount_{};
+
+    captureFileHeader header_{};
+    packedEventEncoder encoder_{};
+    std::thread thread_;
+    std::atomic_bool open_{ false };
+    std::atomic_bool stop_{ false };
+    std::atomic<std::uint64_t> eventsWritten_{};
+    std::atomic<std::uint64_t> openedNs_{};
+};
+
+// Read-only view of a capture file, mapped into memory: packedSlots() points straight into the mapping and
+// forEachEvent() decodes them in place, so reading never copies the file.
+class captureReader
+{
+public:
+    captureReader() = default;
+    ~captureReader();
+
+    captureReader(const captureReader&) = delete;
+    captureReader& operator=(const captureReader&) = delete;
+
+    bool open(const std::string& path, std::string* errorMessage);
+    void close() noexcept;
+
+    const captureFileHeader& header() const noexcept
+    {
+        return header_;
+    }
+
+    // False for files that were never closed; their device table is empty.
+    bool isComplete() const noexcept
+    {
+        return (header_.flags & captureFileHeader::completeFlag) != 0;
+    }
+
+    std::span<const packedInputEvent> packedSlots() const noexcept
+    {
+        return packedSlots_;
+    }
+
+    std::span<const captureDeviceEntry> devices() const noexcept
+    {
+        return devices_;
+    }
+
+    // Calls callback(const inputEvent&) for every event in file order; returns how many there were.
+    template <typename Callback> std::size_t forEachEvent(Callback&& callback) const
+    {
+        packedEventDecoder decoder{ header_.epochNs };
+        inputEvent event{};
+        std::size_t count{ 0 };
+        for (const auto& slot : packedSlots_)
+        {
+            if (decoder.feed(slot, event))
+            {
+                callback(static_cast<const inputEvent&>(event));
+                ++count;
+            }
+        }
+        return count;
+    }
+
+private:
+    const void* mapping_{};
+    std::size_t mappingBytes_{};
+#ifdef _WIN32
+    void* fileHandle_{};
+    void* mappingHandle_{};
+#endif
+    captureFileHeader header_{};
+    std::span<const packedInputEvent> packedSlots_;
+    std::span<const captureDeviceEntry> devices_;
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCoreCaptureFileH
@@ -0,0 +1,77 @@
+#ifndef inputTesterCoreChatterDetectorH
+#define inputTesterCoreChatterDetectorH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace inputTester
+{
+
+struct keyChatterStats
+{
+    static constexpr std::uint64_t noInterval{ std::numeric_limits<std::uint64_t>::max() };
+
+    std::uint32_t presses{};
+    std::uint32_t bounces{};                      // presses that followed a release within the window
+    std::uint64_t minReleaseToPressNs{ noInterval }; // shortest release -> press gap seen on the key
+    std::uint64_t lastBounceNs{};
+};
+
+// Flags switch chatter: a key that reads released and pressed again faster than a finger can, i.e. a
+// release -> press gap shorter than the window. Everything is kept in flat per-key arrays indexed by key id,
+// so record() is O(1), never allocates and the footprint is fixed however fast transitions arrive.
+// Presses while a key is already down (auto-repeat) and ids outside [0, keyCount) are ignored.
+class chatterDetector
+{
+public:
+    // Scan codes with the extended offset and virtual keys both fit.
+    static constexpr std::size_t keyCount{ 1'024 };
+    static constexpr std::uint64_t defaultWindowNs{ 10'000'000 };
+
+    explicit chatterDetector(std::uint64_t windowNs = defaultWindowNs) noexcept;
+
+    // Returns true when this transition is a bounce. timestampNs must be non-decreasing per key.
+    bool record(std::uint32_t keyId, bool pressed, std::uint64_t timestampNs) noexcept;
+
+    bool isChattering(std::uint32_t keyId) const noexcept
+    {
+        return keyId < keyCount && bounces_[keyId] != 0;
+    }
+
+    keyChatterStats stats(std::uint32_t keyId) const noexcept;
+
+    std::uint64_t totalBounces() const noexcept
+    {
+        return totalBounces_;
+    }
+
+    std::size_t chatteringKeyCount() const noexcept
+    {
+        return chatteringKeys_;
+    }
+
+    std::uint64_t windowNs() const noexcept
+    {
+        return windowNs_;
+    }
+
+    void reset() noexcept;
+
+private:
+    std::uint64_t windowNs_;
+    // Only the first two arrays are touched for ordinary presses.
+    std::array<std::uint64_t, keyCount> lastReleaseNs_{};
+    std::array<std::uint8_t, keyCount> down_{};
+    std::array<std::uint32_t, keyCount> presses_{};
+    std::array<std::uint32_t, keyCount> bounces_{};
+    std::array<std::uint64_t, keyCount> minReleaseToPressNs_{};
+    std::array<std::uint64_t, keyCount> lastBounceNs_{};
+    std::uint64_t totalBounces_{};
+    std::size_t chatteringKeys_{};
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCoreChatterDetectorH
@@ -0,0 +1,54 @@
+#ifndef inputTesterCoreClockDomainH
+#define inputTesterCoreClockDomainH
+
+#include <cstdint>
+
+namespace inputTester
+{
+
+// Clocks that input sources stamp events with.
+// steady: std::chrono::steady_clock, the domain every inputEvent timestamp is stored in.
+// monotonic / realtime: CLOCK_MONOTONIC / CLOCK_REALTIME (evdev record times).
+enum class sourceClock : std::uint8_t
+{
+    steady = 0,
+    monotonic,
+    realtime,
+};
+
+// Reads clock now, in nanoseconds; clocks a platform does not have read as steady.
+std::uint64_t readSourceClockNs(sourceClock clock);
+
+// Maps timestamps from a backend's source clock onto the steady clock with a fixed offset measured by
+// calibrate(). Calibrate again after the source clock may have been stepped (realtime).
+class clockDomainConverter
+{
+public:
+    explicit clockDomainConverter(sourceClock clock = sourceClock::steady);
+
+    void calibrate();
+
+    std::uint64_t toSteadyNs(std::uint64_t sourceNs) const noexcept
+    {
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(sourceNs) + offsetNs_);
+    }
+
+    sourceClock clock() const noexcept
+    {
+        return clock_;
+    }
+
+    // steady = source + offset.
+    std::int64_t offsetNs() const noexcept
+    {
+        return offsetNs_;
+    }
+
+private:
+    sourceClock clock_{ sourceClock::steady };
+    std::int64_t offsetNs_{};
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCoreClockDomainH
@@ -0,0 +1,128 @@
+#ifndef inputTesterCoreDebounceSimulatorH
+#define inputTesterCoreDebounceSimulatorH
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "inputtester/core/inputEvent.h"
+
+namespace inputTester
+{
+
+// Debounce schemes as keyboard firmware implements them.
+// symmetricEager: a change is reported at once, then the key ignores its input for the window.
+// symmetricDeferred: a change is reported once the key has read the same for the whole window.
+// globalDeferred: like symmetricDeferred, but any change on the board restarts one shared timer.
+// asymmetricEagerDeferred: presses are reported at once, releases once stable for the window.
+enum class debounceAlgorithm : std::uint8_t
+{
+    symmetricEager = 0,
+    symmetricDeferred,
+    globalDeferred,
+    asymmetricEagerDeferred,
+};
+
+struct debounceModel
+{
+    debounceAlgorithm algorithm{ debounceAlgorithm::symmetricDeferred };
+    std::uint64_t windowNs{ 5'000'000 };
+};
+
+struct debounceKeyReport
+{
+    std::uint32_t keyId{};
+    std::uint64_t rawTransitions{};
+    std::uint64_t reportedTransitions{};
+    std::uint64_t suppressedTransitions{}; // raw edges that never reached the host: the chatter filtered out
+    std::uint64_t totalAddedLatencyNs{};
+    std::uint64_t maxAddedLatencyNs{};
+};
+
+struct debounceReport
+{
+    debounceModel model{};
+    std::uint64_t rawTransitions{};
+    std::uint64_t reportedTransitions{};
+    std::uint64_t suppressedTransitions{};
+    double meanAddedLatencyNs{};
+    std::uint64_t maxAddedLatencyNs{};
+    std::vector<debounceKeyReport> keys; // keys with at least one raw transition, by key id
+};
+
+enum class debounceExecution : std::uint8_t
+{
+    sequential = 0,
+    parallel, // one worker thread per group of models
+};
+
+// Replays recorded keyboard transitions through several debounce models in a single pass. The recording
+// is treated as the raw switch signal; each model's reported transitions are compared with it for the
+// latency the model adds (from the first raw edge of a burst to the report) and the edges it suppresses.
+// Every model keeps its per-key state in one flat array indexed by key id (scan code, +256 for extended
+// keys), so a multi-million-event replay is a linear scan. feed() can be called with consecutive chunks.
+class debounceSimulator
+{
+public:
+    static constexpr std::size_t keyCount{ 1'024 };
+    static constexpr std::uint32_t extendedKeyOffset{ 256 };
+
+    explicit debounceSimulator(std::span<const debounceModel> models);
+
+    // Non-keyboard, text and auto-repeat events are skipped; timestamps use sourceTimestampNs.
+    void feed(std::span<const inputEvent> events);
+
+    // Settles what is still pending as if the input stayed unchanged after the last event.
+    std::vector<debounceReport> finish();
+
+private:
+    struct keyState
+    {
+        std::uint64_t lastRawChangeNs{};
+        std::uint64_t burstStartNs{};
+        std::uint64_t revertedNs{};   // when raw last fell back to the reported state, if reverted
+        std::uint64_t lockoutEndNs{}; // symmetricEager only
+        bool raw{ false };
+        bool reported{ false };
+        bool reverted{ false }; // cleared by each report
+        bool queued{ false };   // on modelState::divergent
+    };
+
+    struct keyCounters
+    {
+        std::uint64_t rawTransitions{};
+        std::uint64_t reportedTransitions{};
+        std::uint64_t totalAddedLatencyNs{};
+        std::uint64_t maxAddedLatencyNs{};
+    };
+
+    struct modelState
+    {
+        debounceModel model{};
+        std::vector<keyState> keys;
+        std::vector<keyCounters> counters;
+        // globalDeferred: keys whose raw state differs from the reported one, and the last change on any key.
+        std::vector<std::uint32_t> divergent;
+        std::uint64_t lastAnyChangeNs{};
+    };
+
+    static void settle(modelState& state, std::uint32_t keyId, std::uint64_t nowNs);
+    static void settleGlobal(modelState& state, std::uint64_t nowNs);
+    static void applyEdge(modelState& state, std::uint32_t keyId, bool pressed, std::uint64_t nowNs);
+    static void report(modelState& state, std::uint32_t keyId, std::uint64_t atNs);
+    static debounceReport summarize(const modelState& state);
+
+    std::vector<modelState> models_;
+    std::vector<std::uint8_t> rawDown_; // input state, to tell auto-repeat from presses
+    std::uint64_t lastEventNs_{};
+};
+
+// Runs every model over events; parallel splits the models across threads, each replaying the whole
+// recording. Reports come back in the order of models.
+std::vector<debounceReport> simulateDebounce(std::span<const inputEvent> events, std::span<const debounceModel> models,
+                                             debounceExecution execution = debounceExecution::sequential);
+
+} // namespace inputTester
+
+#endif // inputTesterCoreDebounceSimulatorH
@@ -19,6 +19,7 @@ enum class eventKind : std::uint8_t
     unknown = 0,
     keyDown,
     keyUp,
+    motion,
 };
 
 inline std::uint64_t nowTimestampNs()
@@ -27,9 +28,14 @@ inline std::uint64_t nowTimestampNs()
         .count();
 }
 
+// Both timestamps are in the steady clock domain (nowTimestampNs()).
+// sourceTimestampNs: when the device or OS reported the event, converted from the backend's source clock;
+// equal to receiveTimestampNs when the source offers no timestamp of its own.
+// receiveTimestampNs: when the backend picked the event up.
 struct inputEvent
 {
-    std::uint64_t timestampNs{};
+    std::uint64_t sourceTimestampNs{};
+    std::uint64_t receiveTimestampNs{};
     std::uint32_t deviceId{};
     deviceType device{ deviceType::unknown };
     eventKind kind{ eventKind::unknown };
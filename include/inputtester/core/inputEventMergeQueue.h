@@ -0,0 +1,313 @@
+#ifndef inputTesterCoreInputEventMergeQueueH
+#define inputTesterCoreInputEventMergeQueueH
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "inputtester/core/inputEventQueue.h"
+#include "inputtester/core/inputEventSink.h"
+#include "inputtester/core/queueNotifier.h"
+
+namespace inputTester
+{
+
+// Multi-producer front end built from one SPSC inputEventQueue lane per producer thread, so producers
+// never contend on a shared index. A thread claims a lane on its first event and keeps it; threads beyond
+// maxProducers have their events counted as dropped. The single consumer merges the lanes by sourceTimestampNs.
+class inputEventMergeQueue final : public inputEventSink
+{
+public:
+    static constexpr std::size_t defaultMaxProducers{ 8 };
+
+    // Every lane and its merge staging buffer is allocated here; nothing allocates after construction.
+    explicit inputEventMergeQueue(std::size_t maxProducers = defaultMaxProducers,
+                                  overflowPolicy policy = overflowPolicy::dropNewest,
+                                  std::size_t capacityPerLane = inputEventQueue::defaultCapacity,
+                                  ringMemoryOptions memory = {})
+        : id_{ nextQueueId().fetch_add(1, std::memory_order_relaxed) }
+    {
+        const auto laneCount{ std::max<std::size_t>(maxProducers, 1) };
+        laneOwners_ = std::make_unique<std::atomic<std::thread::id>[]>(laneCount);
+        lanes_.reserve(laneCount);
+        staging_.resize(laneCount);
+        stagedEnqueueNs_.resize(laneCount);
+        cursors_.resize(laneCount);
+        for (std::size_t lane = 0; lane < laneCount; ++lane)
+        {
+            lanes_.push_back(std::make_unique<inputEventQueue>(policy, capacityPerLane, memory));
+            staging_[lane].reserve(lanes_.back()->capacity());
+            stagedEnqueueNs_[lane].reserve(lanes_.back()->capacity());
+        }
+    }
+
+    inputEventMergeQueue(const inputEventMergeQueue&) = delete;
+    inputEventMergeQueue& operator=(const inputEventMergeQueue&) = delete;
+
+    // All lanes signal one shared wakeup handle; call before any producer starts.
+    bool enableNotifications()
+    {
+        auto notifier{ std::make_shared<queueNotifier>() };
+        if (!notifier->isValid())
+        {
+            return false;
+        }
+        for (auto& lane : lanes_)
+        {
+            lane->enableNotifications(notifier);
+        }
+        notifier_ = std::move(notifier);
+        return true;
+    }
+
+    int notificationHandle() const
+    {
+        return notifier_ != nullptr ? notifier_->handle() : -1;
+    }
+
+    void acknowledgeNotification()
+    {
+        if (notifier_ != nullptr)
+        {
+            notifier_->acknowledge();
+        }
+    }
+
+    // Enqueue stamps on every lane (see inputEventQueue::enableEnqueueStamps); call before any producer starts.
+    bool enableEnqueueStamps()
+    {
+        return std::all_of(lanes_.begin(), lanes_.end(), [](const auto& lane) { return lane->enableEnqueueStamps(); });
+    }
+
+    // Consumer: the enqueue stamp of the event last handed to a drain callback; 0 unless stamps are enabled.
+    std::uint64_t lastEnqueueTimestampNs() const
+    {
+        return lastEnqueueNs_;
+    }
+
+    void onInputEvent(const inputEvent& event) override
+    {
+        if (auto* lane{ laneForThisThread() })
+        {
+            lane->onInputEvent(event);
+            return;
+        }
+        unassigned_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool providesSlots() const noexcept override
+    {
+        return true;
+    }
+
+    inputEvent* reserveEvent() override
+    {
+        if (auto* lane{ laneForThisThread() })
+        {
+            return lane->reserveEvent();
+        }
+        unassigned_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    void commitEvent() override
+    {
+        if (auto* lane{ laneForThisThread() })
+        {
+            lane->commitEvent();
+        }
+    }
+
+    // Invokes callback(const inputEvent&) on every pending event, ordered by sourceTimestampNs across lanes
+    // (within one lane, enqueue order is kept). Events that arrive during the call may be delivered
+    // after later-stamped ones already handed out. Returns the count.
+    template <typename Callback> std::size_t drain(Callback&& callback)
+    {
+        const auto claimed{ claimedLanes() };
+        if (claimed <= 1)
+        {
+            // A single producer is already in order: drain in place without staging.
+            auto& lane{ *lanes_.front() };
+            return lane.drain(
+                [this, &lane, &callback](const inputEvent& event)
+                {
+                    lastEnqueueNs_ = lane.lastEnqueueTimestampNs();
+                    callback(event);
+                });
+        }
+
+        std::size_t total{ 0 };
+        bool morePending{ true };
+        while (morePending)
+        {
+            morePending = false;
+            for (std::size_t lane = 0; lane < claimed; ++lane)
+            {
+                auto& staged{ staging_[lane] };
+                auto& stagedEnqueueNs{ stagedEnqueueNs_[lane] };
+                staged.clear();
+                stagedEnqueueNs.clear();
+                const auto limit{ std::min(staged.capacity(), stagedEnqueueNs.capacity()) };
+                auto& source{ *lanes_[lane] };
+                const auto count{ source.drain(
+                    [&staged, &stagedEnqueueNs, &source](const inputEvent& event)
+                    {
+                        staged.push_back(event);
+                        stagedEnqueueNs.push_back(source.lastEnqueueTimestampNs());
+                    },
+                    limit) };
+                morePending = morePending || count == limit;
+            }
+            total += mergeStaged(claimed, callback);
+        }
+        return total;
+    }
+
+    // Lane counters summed over all lanes; highWaterMark is the deepest single lane. Events from threads
+    // that found no free lane are included in dropped.
+    inputEventQueueCounters counters() const
+    {
+        inputEventQueueCounters total{};
+        for (const auto& lane : lanes_)
+        {
+            const auto laneCounters{ lane->counters() };
+            total.enqueued += laneCounters.enqueued;
+            total.dropped += laneCounters.dropped;
+            total.coalesced += laneCounters.coalesced;
+            total.highWaterMark = std::max(total.highWaterMark, laneCounters.highWaterMark);
+        }
+        total.dropped += unassigned_.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    overflowPolicy policy() const
+    {
+        return lanes_.front()->policy();
+    }
+
+    // Per-lane capacity.
+    std::size_t capacity() const
+    {
+        return lanes_.front()->capacity();
+    }
+
+    std::size_t maxProducers() const
+    {
+        return lanes_.size();
+    }
+
+    std::size_t producerCount() const
+    {
+        return claimedLanes();
+    }
+
+    bool isMemoryLocked() const
+    {
+        return std::all_of(lanes_.begin(), lanes_.end(), [](const auto& lane) { return lane->isMemoryLocked(); });
+    }
+
+private:
+    // The lane a thread last used, so a thread feeding one queue skips the owner scan.
+    struct laneBinding
+    {
+        std::uint64_t queueId{};
+        inputEventQueue* lane{};
+    };
+
+    static std::atomic<std::uint64_t>& nextQueueId()
+    {
+        static std::atomic<std::uint64_t> id{ 1 };
+        return id;
+    }
+
+    std::size_t claimedLanes() const
+    {
+        return std::min(nextLane_.load(std::memory_order_acquire), lanes_.size());
+    }
+
+    // The queue records which thread owns each lane, so a thread finds its lane again however many queues it
+    // feeds in between; the thread_local binding only caches the last lookup.
+    inputEventQueue* laneForThisThread()
+    {
+        thread_local laneBinding binding{};
+        if (binding.queueId == id_)
+        {
+            return binding.lane;
+        }
+
+        const auto self{ std::this_thread::get_id() };
+        const auto claimed{ claimedLanes() };
+        inputEventQueue* lane{ nullptr };
+        for (std::size_t index = 0; index < claimed && lane == nullptr; ++index)
+        {
+            if (laneOwners_[index].load(std::memory_order_relaxed) == self)
+            {
+                lane = lanes_[index].get();
+            }
+        }
+        if (lane == nullptr)
+        {
+            const auto index{ nextLane_.fetch_add(1, std::memory_order_acq_rel) };
+            if (index < lanes_.size())
+            {
+                laneOwners_[index].store(self, std::memory_order_relaxed);
+                lane = lanes_[index].get();
+            }
+        }
+        // Threads without a lane are cached too, so their events are dropped without another claim.
+        binding = laneBinding{ id_, lane };
+        return lane;
+    }
+
+    // k-way merge of the staged runs; the lane count is small, so a linear scan beats a heap.
+    template <typename Callback> std::size_t mergeStaged(std::size_t claimed, Callback& callback)
+    {
+        std::fill_n(cursors_.begin(), claimed, 0);
+        std::size_t total{ 0 };
+        for (;;)
+        {
+            std::size_t best{ claimed };
+            std::uint64_t bestTimestamp{ std::numeric_limits<std::uint64_t>::max() };
+            for (std::size_t lane = 0; lane < claimed; ++lane)
+            {
+                if (cursors_[lane] < staging_[lane].size() &&
+                    (best == claimed || staging_[lane][cursors_[lane]].sourceTimestampNs < bestTimestamp))
+                {
+                    best = lane;
+                    bestTimestamp = staging_[lane][cursors_[lane]].sourceTimestampNs;
+                }
+            }
+            if (best == claimed)
+            {
+                return total;
+            }
+            lastEnqueueNs_ = stagedEnqueueNs_[best][cursors_[best]];
+            callback(static_cast<const inputEvent&>(staging_[best][cursors_[best]]));
+            ++cursors_[best];
+            ++total;
+        }
+    }
+
+    std::uint64_t id_{};
+    std::vector<std::unique_ptr<inputEventQueue>> lanes_;
+    std::vector<std::vector<inputEvent>> staging_; // consumer-private
+    std::vector<std::size_t> cursors_;              // consumer-private
+    std::uint64_t lastEnqueueNs_{};                 // consumer-private
+    // Consumer-private, parallel to staging_.
+    std::vector<std::vector<std::uint64_t>> stagedEnqueueNs_;
+
+    std::unique_ptr<std::atomic<std::thread::id>[]> laneOwners_; // by lane; written once, by the claiming thread
+
+    alignas(64) std::atomic<std::size_t> nextLane_{ 0 };
+    std::atomic<std::uint64_t> unassigned_{}; // events from threads that found no free lane
+    std::shared_ptr<queueNotifier> notifier_;
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCoreInputEventMergeQueueH
@@ -1,27 +1,514 @@
 #ifndef inputTesterCoreInputEventQueueH
 #define inputTesterCoreInputEventQueueH
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
 #include "inputtester/core/inputEventSink.h"
+#include "inputtester/core/packedInputEvent.h"
+#include "inputtester/core/queueNotifier.h"
 #include "inputtester/core/spscRingBuffer.h"
 
 namespace inputTester
 {
 
+// What the producer does when the ring is full.
+// dropNewest: the incoming event is discarded and counted as dropped.
+// overwriteOldest: the oldest queued event is evicted (counted as dropped) to make room.
+// coalesceMotion: mouse motion that finds the ring full is parked beside it, and newer parked motion replaces it
+// (counted as coalesced). The consumer picks the parked motion up itself and delivers it right after the events
+// queued ahead of it, so the last motion of a burst shows up without waiting for another event. Other events
+// behave as under dropNewest and still take any slot the consumer frees while a motion is parked.
+enum class overflowPolicy : std::uint8_t
+{
+    dropNewest = 0,
+    overwriteOldest,
+    coalesceMotion,
+};
+
+struct inputEventQueueCounters
+{
+    std::uint64_t enqueued{};
+    std::uint64_t dropped{};
+    std::uint64_t coalesced{};
+    std::uint64_t highWaterMark{};
+};
+
+// Events are stored as 16-byte packedInputEvent slots: packed on push and unpacked on pop/drain, so only
+// the ring sees the wire form. Events that do not fit one slot take escapedSlotCount slots.
 class inputEventQueue final : public inputEventSink
 {
 public:
+    static constexpr std::size_t defaultCapacity{ 2048 };
+
+    // capacity (in slots) is rounded up to a power of two that holds at least one escaped event; the ring is
+    // heap-backed and sized once here.
+    explicit inputEventQueue(overflowPolicy policy = overflowPolicy::dropNewest,
+                             std::size_t capacity = defaultCapacity, ringMemoryOptions memory = {})
+        : policy_{ policy }, queue_{ std::max(capacity, escapedSlotCount), memory }, encoder_{ nowTimestampNs() },
+          decoder_{ encoder_.epochNs() }
+    {
+    }
+
+    // Creates the consumer wakeup handle; call before the producer starts. Returns false where
+    // unsupported, in which case the consumer keeps polling.
+    bool enableNotifications()
+    {
+        return enableNotifications(std::make_shared<queueNotifier>());
+    }
+
+    // Signals a notifier shared with other queues (e.g. all lanes of a merge queue).
+    bool enableNotifications(std::shared_ptr<queueNotifier> notifier)
+    {
+        if (notifier == nullptr || !notifier->isValid())
+        {
+            return false;
+        }
+        notifier_ = std::move(notifier);
+        return true;
+    }
+
+    // Readable once after each empty -> non-empty transition the consumer has seen; -1 when disabled.
+    int notificationHandle() const
+    {
+        return notifier_ != nullptr ? notifier_->handle() : -1;
+    }
+
+    // Consumer: clear the wakeup before draining so a push during the drain re-signals.
+    void acknowledgeNotification()
+    {
+        if (notifier_ != nullptr)
+        {
+            notifier_->acknowledge();
+        }
+    }
+
+    // Opt-in latency tracing: the producer stamps each event as it is committed and the consumer reads the
+    // stamp back through lastEnqueueTimestampNs() while the event is delivered. Call before the producer
+    // starts. Not supported under overwriteOldest, where evictions break the enqueue/delivery pairing.
+    bool enableEnqueueStamps()
+    {
+        if (policy_ == overflowPolicy::overwriteOldest)
+        {
+            return false;
+        }
+        // Keyed by the ring slot holding an event's last part, so a stamp is only rewritten once the consumer
+        // has released that slot.
+        enqueueStamps_ = std::make_unique<std::atomic<std::uint64_t>[]>(queue_.capacity());
+        return true;
+    }
+
+    // Consumer: when the event last returned by tryPop or handed to a drain callback was committed to the
+    // queue, in the steady domain; 0 unless enqueue stamps are enabled.
+    std::uint64_t lastEnqueueTimestampNs() const
+    {
+        return lastEnqueueNs_;
+    }
+
     void onInputEvent(const inputEvent& event) override
     {
-        queue_.tryPush(event);
+        switch (policy_)
+        {
+        case overflowPolicy::dropNewest:
+            pushOrDrop(event);
+            break;
+        case overflowPolicy::overwriteOldest:
+            pushEvictingOldest(event);
+            break;
+        case overflowPolicy::coalesceMotion:
+            pushCoalescingMotion(event);
+            break;
+        }
     }
 
     bool tryPop(inputEvent& out)
     {
-        return queue_.tryPop(out);
+        if (policy_ == overflowPolicy::overwriteOldest)
+        {
+            packedInputEvent slot{};
+            while (queue_.tryPopEvictable(slot))
+            {
+                if (decoder_.feed(slot, out))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+        for (;;)
+        {
+            const auto pending{ queue_.peek() };
+            collectParkedMotion();
+            if (slotsBeforeCollectedMotion() == 0)
+            {
+                out = takeCollectedMotion();
+                return true;
+            }
+            if (pending.empty())
+            {
+                return false;
+            }
+            const bool complete{ decoder_.feed(pending.front(), out) };
+            if (complete)
+            {
+                noteDelivered(queue_.poppedCount());
+            }
+            queue_.release(1);
+            if (complete)
+            {
+                return true;
+            }
+        }
+    }
+
+    // A 40-byte inputEvent cannot be built inside a 16-byte slot, so the backend fills a producer-side staging
+    // event and commitEvent() packs it straight into the reserved ring slot; nothing else is copied. Under
+    // dropNewest a full ring refuses up front so the backend can skip building the event.
+    bool providesSlots() const noexcept override
+    {
+        return true;
+    }
+
+    inputEvent* reserveEvent() override
+    {
+        if (policy_ == overflowPolicy::dropNewest && queue_.reserve() == nullptr)
+        {
+            bump(dropped_);
+            return nullptr;
+        }
+        staged_ = inputEvent{};
+        return &staged_;
+    }
+
+    void commitEvent() override
+    {
+        onInputEvent(staged_);
+    }
+
+    // Invokes callback(const inputEvent&) on pending events, unpacking each contiguous run of slots in place
+    // and releasing it with a single index publish; returns the count.
+    // With notifications enabled, the consumer re-arms the wakeup once the queue is empty. When
+    // maxEvents is reached the wakeup is not re-armed and the caller must drain again.
+    template <typename Callback>
+    std::size_t drain(Callback&& callback, std::size_t maxEvents = std::numeric_limits<std::size_t>::max())
+    {
+        noteDepth(queue_.size());
+        std::size_t total{ 0 };
+        for (;;)
+        {
+            total += drainPending(callback, maxEvents - total);
+            if (total == maxEvents || notifier_ == nullptr)
+            {
+                return total;
+            }
+            // Arm, then re-check: a push that raced with the empty check either sees the flag and
+            // signals, or is visible here and gets drained now.
+            consumerWaiting_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (queue_.size() == 0 && (parkedMotion_.load(std::memory_order_relaxed) & parkedFresh) == 0)
+            {
+                return total;
+            }
+            consumerWaiting_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    overflowPolicy policy() const
+    {
+        return policy_;
+    }
+
+    // In slots; one per event unless the event needed the escaped form.
+    std::size_t capacity() const
+    {
+        return queue_.capacity();
+    }
+
+    bool isMemoryLocked() const
+    {
+        return queue_.isLocked();
+    }
+
+    // Lock-free snapshot; the producer counters are single-writer so individual fields are exact,
+    // but the fields are not read atomically as a group. highWaterMark is in slots; under overwriteOldest
+    // an evicted escaped event is counted once per evicted slot.
+    inputEventQueueCounters counters() const
+    {
+        inputEventQueueCounters snapshot{};
+        snapshot.enqueued = enqueued_.load(std::memory_order_relaxed);
+        snapshot.dropped = dropped_.load(std::memory_order_relaxed);
+        snapshot.coalesced = coalesced_.load(std::memory_order_relaxed);
+        snapshot.highWaterMark = highWaterMark_.load(std::memory_order_relaxed);
+        return snapshot;
     }
 
 private:
-    spscRingBuffer<inputEvent, 1024> queue_{};
+    static bool isMotion(const inputEvent& event)
+    {
+        return event.kind == eventKind::motion;
+    }
+
+    // Single writer per counter, so a relaxed load + store avoids a locked RMW on the hot path.
+    static void bump(std::atomic<std::uint64_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void noteDepth(std::size_t depth)
+    {
+        if (depth > highWaterMark_.load(std::memory_order_relaxed))
+        {
+            highWaterMark_.store(depth, std::memory_order_relaxed);
+        }
+    }
+
+    // Producer: called once the ring is known to have room for slotCount slots, before they are published.
+    void stampEnqueue(std::size_t slotCount)
+    {
+        if (enqueueStamps_ != nullptr)
+        {
+            const auto lastSlot{ (queue_.pushedCount() + slotCount - 1) & (queue_.capacity() - 1) };
+            enqueueStamps_[lastSlot].store(nowTimestampNs(), std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer: lastSlot is the absolute index of the event's last slot, read before that slot is released.
+    // The ring's acquire of the published slot also makes the stamp written before it visible.
+    void noteDelivered(std::size_t lastSlot)
+    {
+        if (enqueueStamps_ != nullptr)
+        {
+            lastEnqueueNs_ = enqueueStamps_[lastSlot & (queue_.capacity() - 1)].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Consumer: takes over the parked motion, unless the one collected earlier is still waiting for its turn.
+    void collectParkedMotion()
+    {
+        if (policy_ != overflowPolicy::coalesceMotion || hasCollectedMotion_ ||
+            (parkedMotion_.load(std::memory_order_relaxed) & parkedFresh) == 0)
+        {
+            return;
+        }
+        const auto previous{ parkedMotion_.exchange(motionFront_, std::memory_order_acq_rel) };
+        motionFront_ = static_cast<std::uint8_t>(previous & parkedIndexMask);
+        hasCollectedMotion_ = (previous & parkedFresh) != 0;
+    }
+
+    // Consumer: slots still to deliver ahead of the collected motion; the maximum when none is held. The
+    // consumer peeks before it collects, so a motion parked after the peek sorts after every slot the peek saw.
+    std::size_t slotsBeforeCollectedMotion() const
+    {
+        return hasCollectedMotion_ ? motionBuffers_[motionFront_].after - queue_.poppedCount()
+                                   : std::numeric_limits<std::size_t>::max();
+    }
+
+    const inputEvent& takeCollectedMotion()
+    {
+        hasCollectedMotion_ = false;
+        const auto& parked{ motionBuffers_[motionFront_] };
+        lastEnqueueNs_ = parked.enqueueNs;
+        return parked.event;
+    }
+
+    template <typename Callback> std::size_t drainPending(Callback& callback, std::size_t maxEvents)
+    {
+        std::size_t total{ 0 };
+        inputEvent event{};
+        if (policy_ == overflowPolicy::overwriteOldest)
+        {
+            // Slots may be evicted under us, so copy out and confirm each one.
+            packedInputEvent slot{};
+            while (total < maxEvents && queue_.tryPopEvictable(slot))
+            {
+                if (decoder_.feed(slot, event))
+                {
+                    callback(static_cast<const inputEvent&>(event));
+                    ++total;
+                }
+            }
+            return total;
+        }
+        while (total < maxEvents)
+        {
+            auto pending{ queue_.peek() };
+            collectParkedMotion();
+            const auto beforeMotion{ slotsBeforeCollectedMotion() };
+            if (beforeMotion == 0)
+            {
+                callback(takeCollectedMotion());
+                ++total;
+                continue;
+            }
+            pending = pending.first(std::min(pending.size(), beforeMotion));
+            if (pending.empty())
+            {
+                break;
+            }
+            std::size_t consumed{ 0 };
+            while (consumed < pending.size() && total < maxEvents)
+            {
+                if (decoder_.feed(pending[consumed++], event))
+                {
+                    noteDelivered(queue_.poppedCount() + consumed - 1);
+                    callback(static_cast<const inputEvent&>(event));
+                    ++total;
+                }
+            }
+            queue_.release(consumed);
+        }
+        return total;
+    }
+
+    // Producer: after publishing, wake the consumer only if it armed itself on an empty queue.
+    void notifyConsumer()
+    {
+        if (notifier_ == nullptr)
+        {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerWaiting_.load(std::memory_order_relaxed) &&
+            consumerWaiting_.exchange(false, std::memory_order_acq_rel))
+        {
+            notifier_->signal();
+        }
+    }
+
+    // All-or-nothing, so an escaped event never lands partially. slotsNeeded reports the record size.
+    // A one-slot event is packed in place into the slot reserved at the ring's head.
+    bool tryPushPacked(const inputEvent& event, std::size_t* slotsNeeded = nullptr)
+    {
+        auto* slot{ queue_.reserve() };
+        packedInputEvent unused{};
+        const bool fitsOneSlot{ encoder_.tryPack(event, slot != nullptr ? *slot : unused) };
+        if (slotsNeeded != nullptr)
+        {
+            *slotsNeeded = fitsOneSlot ? 1 : escapedSlotCount;
+        }
+        if (fitsOneSlot)
+        {
+            if (slot == nullptr)
+            {
+                return false;
+            }
+            stampEnqueue(1);
+            queue_.commit();
+            return true;
+        }
+        if (!queue_.hasRoomFor(escapedSlotCount))
+        {
+            return false;
+        }
+        stampEnqueue(escapedSlotCount);
+        std::array<packedInputEvent, escapedSlotCount> escaped{};
+        encoder_.packEscaped(event, escaped);
+        return queue_.tryPushAll(escaped);
+    }
+
+    bool pushOrDrop(const inputEvent& event)
+    {
+        if (tryPushPacked(event))
+        {
+            bump(enqueued_);
+            notifyConsumer();
+            return true;
+        }
+        bump(dropped_);
+        return false;
+    }
+
+    void pushEvictingOldest(const inputEvent& event)
+    {
+        std::size_t slotsNeeded{ 1 };
+        while (!tryPushPacked(event, &slotsNeeded))
+        {
+            if (queue_.tryEvictOldest(slotsNeeded))
+            {
+                bump(dropped_);
+            }
+        }
+        bump(enqueued_);
+        notifyConsumer();
+    }
+
+    void pushCoalescingMotion(const inputEvent& event)
+    {
+        if (!isMotion(event))
+        {
+            pushOrDrop(event);
+            return;
+        }
+        if (tryPushPacked(event))
+        {
+            bump(enqueued_);
+        }
+        else
+        {
+            parkMotion(event);
+        }
+        notifyConsumer();
+    }
+
+    // Producer: records how many slots were pushed before the motion, so the consumer delivers it after exactly
+    // those even if more events get a slot while it is parked.
+    void parkMotion(const inputEvent& event)
+    {
+        auto& parked{ motionBuffers_[motionBack_] };
+        parked.event = event;
+        parked.after = queue_.pushedCount();
+        parked.enqueueNs = enqueueStamps_ != nullptr ? nowTimestampNs() : 0;
+        const auto previous{ parkedMotion_.exchange(static_cast<std::uint8_t>(motionBack_ | parkedFresh),
+                                                    std::memory_order_acq_rel) };
+        motionBack_ = static_cast<std::uint8_t>(previous & parkedIndexMask);
+        bump((previous & parkedFresh) != 0 ? coalesced_ : enqueued_);
+    }
+
+    struct parkedMotionBuffer
+    {
+        inputEvent event{};
+        std::size_t after{};        // ring slots pushed before the motion was parked
+        std::uint64_t enqueueNs{};  // 0 unless enqueue stamps are enabled
+    };
+
+    // parkedMotion_ holds the index of the buffer shared between the two sides, plus parkedFresh while it holds
+    // a motion the consumer has not collected.
+    static constexpr std::uint8_t parkedIndexMask{ 0x3 };
+    static constexpr std::uint8_t parkedFresh{ 0x4 };
+
+    overflowPolicy policy_{ overflowPolicy::dropNewest };
+    spscRingBuffer<packedInputEvent, dynamicCapacity, spscIndexPolicy::cached> queue_;
+
+    // Producer-private state and counters share one line; the consumer only reads the counters.
+    alignas(64) packedEventEncoder encoder_;
+    inputEvent staged_{};          // filled by the backend between reserveEvent() and commitEvent()
+    std::uint8_t motionBack_{ 0 }; // the parked-motion buffer the producer writes next
+    std::atomic<std::uint64_t> enqueued_{};
+    std::atomic<std::uint64_t> dropped_{};
+    std::atomic<std::uint64_t> coalesced_{};
+
+    alignas(64) packedEventDecoder decoder_; // consumer-private
+    std::atomic<std::uint64_t> highWaterMark_{}; // consumer-written
+    std::uint64_t lastEnqueueNs_{};              // consumer-private
+    std::uint8_t motionFront_{ 1 };              // consumer-private: the parked-motion buffer it last collected
+    bool hasCollectedMotion_{ false };           // consumer-private
+
+    // Set by the consumer when it goes idle on an empty queue, cleared by whichever side claims it.
+    alignas(64) std::atomic<bool> consumerWaiting_{ true };
+    std::shared_ptr<queueNotifier> notifier_;
+
+    // coalesceMotion: three buffers so that neither side waits for, or reads, one the other is writing. The
+    // producer and the consumer each own one and swap it for the shared one through parkedMotion_.
+    alignas(64) std::atomic<std::uint8_t> parkedMotion_{ 2 };
+    std::array<parkedMotionBuffer, 3> motionBuffers_{};
+
+    // Indexed by ring slot; null unless enableEnqueueStamps() was called. Read-only once the producer runs.
+    alignas(64) std::unique_ptr<std::atomic<std::uint64_t>[]> enqueueStamps_;
 };
 
 } // namespace inputTester
@@ -11,8 +11,49 @@ class inputEventSink
 public:
     virtual ~inputEventSink() = default;
     virtual void onInputEvent(const inputEvent& event) = 0;
+
+    // Producer-side slot API: backends fill the returned, value-initialised event in place and then call commitEvent().
+    // Only sinks that own per-producer storage (the queues) provide slots; a nullptr from one of them means the
+    // event was refused, e.g. a full dropNewest queue. The base keeps no state, so it has no slot to hand out and
+    // producers go through reserveEvent(sink, fallback) below, which falls back to onInputEvent.
+    virtual bool providesSlots() const noexcept
+    {
+        return false;
+    }
+
+    virtual inputEvent* reserveEvent()
+    {
+        return nullptr;
+    }
+
+    virtual void commitEvent()
+    {
+    }
 };
 
+// Reserves the sink's own slot, or resets the producer's fallback event for a sink without slots. Returns
+// nullptr when the sink refused the event.
+inline inputEvent* reserveEvent(inputEventSink& sink, inputEvent& fallback)
+{
+    if (!sink.providesSlots())
+    {
+        fallback = inputEvent{};
+        return &fallback;
+    }
+    return sink.reserveEvent();
+}
+
+// Completes reserveEvent(sink, fallback): commits the slot, or hands the fallback event to onInputEvent.
+inline void commitEvent(inputEventSink& sink, const inputEvent& fallback)
+{
+    if (sink.providesSlots())
+    {
+        sink.commitEvent();
+        return;
+    }
+    sink.onInputEvent(fallback);
+}
+
 } // namespace inputTester
 
 #endif // inputTesterCoreInputEventSinkH
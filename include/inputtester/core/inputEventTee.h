@@ -0,0 +1,53 @@
+#ifndef inputTesterCoreInputEventTeeH
+#define inputTesterCoreInputEventTeeH
+
+#include "inputEventSink.h"
+
+namespace inputTester
+{
+
+// Hands every event to two sinks, e.g. the UI queue and a captureWriter. Safe for several producer threads: each
+// fills its own thread-local slot, which commitEvent() passes to both sinks.
+class inputEventTee final : public inputEventSink
+{
+public:
+    inputEventTee(inputEventSink& first, inputEventSink& second) : first_{ first }, second_{ second }
+    {
+    }
+
+    void onInputEvent(const inputEvent& event) override
+    {
+        first_.onInputEvent(event);
+        second_.onInputEvent(event);
+    }
+
+    bool providesSlots() const noexcept override
+    {
+        return true;
+    }
+
+    inputEvent* reserveEvent() override
+    {
+        threadSlot() = inputEvent{};
+        return &threadSlot();
+    }
+
+    void commitEvent() override
+    {
+        onInputEvent(threadSlot());
+    }
+
+private:
+    static inputEvent& threadSlot()
+    {
+        thread_local inputEvent slot{};
+        return slot;
+    }
+
+    inputEventSink& first_;
+    inputEventSink& second_;
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCoreInputEventTeeH
@@ -0,0 +1,104 @@
+#ifndef inputTesterCoreIntervalHistogramH
+#define inputTesterCoreIntervalHistogramH
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace inputTester
+{
+
+struct intervalSummary
+{
+    std::uint64_t count{};
+    double meanNs{};
+    double rateHz{};   // 1 / mean interval
+    double jitterNs{}; // standard deviation of the intervals
+    std::uint64_t minNs{};
+    std::uint64_t p1Ns{};
+    std::uint64_t p50Ns{};
+    std::uint64_t p99Ns{};
+    std::uint64_t maxNs{};
+    std::uint64_t outliers{}; // intervals under half or over twice the median
+};
+
+// HDR-style log-linear histogram of event intervals in nanoseconds: each power of two is split into
+// subBucketCount linear buckets, so any recorded value is resolved to within 1 / subBucketCount (~1.6%)
+// across the whole range, from sub-microsecond 8 kHz jitter to multi-second gaps. Memory is fixed
+// (bucketCount counters); record() is O(1) and summarize() walks the buckets once or twice.
+class intervalHistogram
+{
+public:
+    static constexpr unsigned subBucketBits{ 6 };
+    static constexpr std::uint64_t subBucketCount{ 1ULL << subBucketBits };
+    // Values from 2^(maxExponent + 1) ns (~37 minutes) up land in the last bucket.
+    static constexpr unsigned maxExponent{ 40 };
+    static constexpr std::size_t bucketCount{ (maxExponent - subBucketBits + 2) * subBucketCount };
+
+    void record(std::uint64_t intervalNs) noexcept
+    {
+        ++counts_[bucketIndex(intervalNs)];
+        ++count_;
+        minNs_ = count_ == 1 || intervalNs < minNs_ ? intervalNs : minNs_;
+        maxNs_ = intervalNs > maxNs_ ? intervalNs : maxNs_;
+        // Welford's update keeps the variance stable over millions of nearly equal intervals.
+        const auto value{ static_cast<double>(intervalNs) };
+        const auto delta{ value - meanNs_ };
+        meanNs_ += delta / static_cast<double>(count_);
+        squaredDeviationNs_ += delta * (value - meanNs_);
+    }
+
+    void reset() noexcept;
+
+    std::uint64_t count() const noexcept
+    {
+        return count_;
+    }
+
+    // Nearest-rank percentile (0..100) at bucket resolution, clamped to the recorded min / max.
+    std::uint64_t valueAtPercentile(double percent) const noexcept;
+
+    intervalSummary summarize() const noexcept;
+
+    static constexpr std::size_t bucketIndex(std::uint64_t value) noexcept
+    {
+        if (value < subBucketCount)
+        {
+            return static_cast<std::size_t>(value);
+        }
+        const auto exponent{ static_cast<unsigned>(std::bit_width(value)) - 1 };
+        if (exponent > maxExponent)
+        {
+            return bucketCount - 1;
+        }
+        const auto shift{ exponent - subBucketBits };
+        return static_cast<std::size_t>((shift + 1) * subBucketCount + ((value >> shift) & (subBucketCount - 1)));
+    }
+
+    // Smallest value that maps to bucket index.
+    static constexpr std::uint64_t bucketLowNs(std::size_t index) noexcept
+    {
+        if (index < subBucketCount)
+        {
+            return index;
+        }
+        const auto shift{ index / subBucketCount - 1 };
+        return (subBucketCount + index % subBucketCount) << shift;
+    }
+
+private:
+    // Value of the rank-th smallest interval, which lies in bucket index.
+    std::uint64_t rankValueNs(std::uint64_t rank, std::size_t index) const noexcept;
+
+    std::array<std::uint64_t, bucketCount> counts_{};
+    std::uint64_t count_{};
+    std::uint64_t minNs_{};
+    std::uint64_t maxNs_{};
+    double meanNs_{};
+    double squaredDeviationNs_{};
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCoreIntervalHistogramH
@@ -0,0 +1,103 @@
+#ifndef inputTesterCoreLatencyTraceH
+#define inputTesterCoreLatencyTraceH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "inputtester/core/inputEvent.h"
+
+namespace inputTester
+{
+
+// Points an event passes on its way from the device to the screen, in pipeline order.
+// source / receive: the event's own timestamps. enqueue: committed to the input queue.
+// dequeue: handed to the consumer by a drain. handled: the view has applied it.
+// painted: the first paint that completed after the event was handled.
+enum class latencyStage : std::uint8_t
+{
+    source = 0,
+    receive,
+    enqueue,
+    dequeue,
+    handled,
+    painted,
+};
+
+inline constexpr std::size_t latencyStageCount{ 6 };
+
+struct latencySummary
+{
+    std::size_t count{};
+    std::uint64_t p50Ns{};
+    std::uint64_t p99Ns{};
+    std::uint64_t maxNs{};
+};
+
+// Per-event stage timestamps (steady domain, 0 = not reached) in a fixed-size side table indexed by
+// trace sequence; the newest capacity() records are kept. Consumer thread only; storage is allocated
+// once in the constructor, so recording never allocates.
+class latencyTrace
+{
+public:
+    static constexpr std::size_t defaultCapacity{ 4096 };
+
+    using stageStamps = std::array<std::uint64_t, latencyStageCount>;
+
+    // capacity is rounded up to a power of two.
+    explicit latencyTrace(std::size_t capacity = defaultCapacity);
+
+    // Starts the record for an event just taken off the queue and returns its sequence.
+    // enqueueNs comes from the queue's lastEnqueueTimestampNs(); 0 leaves the stage empty.
+    std::uint64_t begin(const inputEvent& event, std::uint64_t enqueueNs, std::uint64_t dequeueNs) noexcept;
+
+    // Ignored for records that were already overwritten.
+    void stamp(std::uint64_t sequence, latencyStage stage, std::uint64_t timestampNs) noexcept;
+
+    // Paint completion: stamps every record begun since the previous call.
+    void stampPainted(std::uint64_t timestampNs) noexcept;
+
+    void reset() noexcept;
+
+    std::size_t capacity() const noexcept
+    {
+        return records_.size();
+    }
+
+    // Records begun since construction or reset(), including overwritten ones.
+    std::uint64_t recorded() const noexcept
+    {
+        return next_;
+    }
+
+    // Calls callback(std::uint64_t sequence, const stageStamps&) for each retained record, oldest first.
+    template <typename Callback> void forEachRecord(Callback&& callback) const
+    {
+        for (auto sequence{ firstRetained() }; sequence < next_; ++sequence)
+        {
+            callback(sequence, static_cast<const stageStamps&>(records_[sequence & mask_]));
+        }
+    }
+
+    // Distribution of (to - from) over the retained records that reached both stages.
+    latencySummary summarize(latencyStage from, latencyStage to);
+
+    static const char* stageName(latencyStage stage) noexcept;
+
+private:
+    std::uint64_t firstRetained() const noexcept
+    {
+        return next_ > records_.size() ? next_ - records_.size() : 0;
+    }
+
+    std::vector<stageStamps> records_;
+    std::vector<std::uint64_t> scratch_; // summarize() working set
+    std::uint64_t mask_{};
+    std::uint64_t next_{};
+    std::uint64_t unpainted_{};
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCoreLatencyTraceH
@@ -0,0 +1,193 @@
+#ifndef inputTesterCorePackedInputEventH
+#define inputTesterCorePackedInputEventH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "inputtester/core/inputEvent.h"
+
+namespace inputTester
+{
+
+// 16-byte queue slot. An event whose fields all fit is stored in one slot:
+//   word0 [0, 48)  sourceTimestampNs - epoch  [48, 56) virtualKey
+//         [56, 62) deviceId                   62 isExtended, 63 isTextEvent
+//   word1 [0, 12)  scanCode                   [12, 33) text (one code point)
+//         [33, 35) kind                       [35, 37) device
+//         37 repeatCount (0 or 1)             [38, 63) receiveTimestampNs - sourceTimestampNs (< ~33 ms)
+//         63 escape (0)
+// Anything else is escaped losslessly: the raw inputEvent bytes are split over escapedSlotCount slots,
+// 15 bytes each, with word1's top byte holding the escape bit, the part index and a 5-bit record tag.
+// Either way decoding restores every field exactly.
+struct packedInputEvent
+{
+    std::uint64_t word0{};
+    std::uint64_t word1{};
+};
+
+static_assert(sizeof(packedInputEvent) == 16);
+
+inline constexpr std::size_t escapedSlotCount{ (sizeof(inputEvent) + 14) / 15 };
+
+namespace detail
+{
+
+inline constexpr std::uint64_t packedTimestampLimit{ std::uint64_t{ 1 } << 48 };
+inline constexpr std::uint64_t packedReceiveDelayLimit{ std::uint64_t{ 1 } << 25 };
+inline constexpr std::uint64_t packedEscapeBit{ std::uint64_t{ 1 } << 63 };
+inline constexpr std::size_t packedEscapePayloadBytes{ 15 };
+
+inline constexpr std::uint64_t bitField(std::uint64_t word, unsigned shift, unsigned width)
+{
+    return (word >> shift) & ((std::uint64_t{ 1 } << width) - 1);
+}
+
+// Little-endian byte order regardless of the host, so escaped records never touch word1's top byte.
+inline std::uint64_t loadBytes(const std::uint8_t* bytes, std::size_t count)
+{
+    std::uint64_t word{};
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        word |= std::uint64_t{ bytes[i] } << (8 * i);
+    }
+    return word;
+}
+
+inline void storeBytes(std::uint64_t word, std::uint8_t* bytes, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        bytes[i] = static_cast<std::uint8_t>(word >> (8 * i));
+    }
+}
+
+} // namespace detail
+
+// Producer side. Source timestamps are stored relative to epochNs, so events stamped within ~78 hours after it
+// pack into one slot; earlier or later ones are escaped, as are events received more than ~33 ms after
+// their source timestamp.
+class packedEventEncoder
+{
+public:
+    explicit packedEventEncoder(std::uint64_t epochNs = 0) : epochNs_{ epochNs }
+    {
+    }
+
+    std::uint64_t epochNs() const
+    {
+        return epochNs_;
+    }
+
+    // Returns false when the event needs the escaped form.
+    bool tryPack(const inputEvent& event, packedInputEvent& out) const
+    {
+        const auto kind{ static_cast<std::uint64_t>(event.kind) };
+        const auto device{ static_cast<std::uint64_t>(event.device) };
+        const auto source{ event.sourceTimestampNs };
+        if (source < epochNs_ || source - epochNs_ >= detail::packedTimestampLimit ||
+            event.receiveTimestampNs < source || event.receiveTimestampNs - source >= detail::packedReceiveDelayLimit ||
+            event.virtualKey > 0xFFU || event.scanCode > 0xFFFU || std::uint32_t{ event.text } > 0x1FFFFFU ||
+            kind > 3 || device > 3 || event.deviceId > 0x3FU || event.repeatCount > 1)
+        {
+            return false;
+        }
+        out.word0 = (source - epochNs_) | (std::uint64_t{ event.virtualKey } << 48) |
+                    (std::uint64_t{ event.deviceId } << 56) | (std::uint64_t{ event.isExtended } << 62) |
+                    (std::uint64_t{ event.isTextEvent } << 63);
+        out.word1 = std::uint64_t{ event.scanCode } | (std::uint64_t{ event.text } << 12) | (kind << 33) |
+                    (device << 35) | (std::uint64_t{ event.repeatCount } << 37) |
+                    ((event.receiveTimestampNs - source) << 38);
+        return true;
+    }
+
+    void packEscaped(const inputEvent& event, std::span<packedInputEvent, escapedSlotCount> out)
+    {
+        std::array<std::uint8_t, escapedSlotCount * detail::packedEscapePayloadBytes> raw{};
+        std::memcpy(raw.data(), &event, sizeof(event));
+        const auto tag{ static_cast<std::uint64_t>(nextTag_++ & 0x1FU) };
+        for (std::size_t part = 0; part < escapedSlotCount; ++part)
+        {
+            const auto* payload{ raw.data() + part * detail::packedEscapePayloadBytes };
+            out[part].word0 = detail::loadBytes(payload, 8);
+            out[part].word1 = detail::loadBytes(payload + 8, 7) | detail::packedEscapeBit |
+                              (std::uint64_t{ part } << 61) | (tag << 56);
+        }
+    }
+
+private:
+    std::uint64_t epochNs_{};
+    std::uint8_t nextTag_{};
+};
+
+// Consumer side. Feed slots in queue order; an escaped record whose parts arrive incomplete or out of
+// order (the oldest slots were evicted) is discarded.
+class packedEventDecoder
+{
+public:
+    explicit packedEventDecoder(std::uint64_t epochNs = 0) : epochNs_{ epochNs }
+    {
+    }
+
+    // Returns true when out holds a complete event.
+    bool feed(const packedInputEvent& slot, inputEvent& out)
+    {
+        if ((slot.word1 & detail::packedEscapeBit) == 0)
+        {
+            escapeParts_ = 0;
+            unpack(slot, out);
+            return true;
+        }
+
+        const auto part{ static_cast<std::size_t>(detail::bitField(slot.word1, 61, 2)) };
+        const auto tag{ static_cast<std::uint8_t>(detail::bitField(slot.word1, 56, 5)) };
+        if (part == 0)
+        {
+            escapeTag_ = tag;
+            escapeParts_ = 0;
+        }
+        else if (part != escapeParts_ || tag != escapeTag_)
+        {
+            escapeParts_ = 0;
+            return false;
+        }
+
+        auto* payload{ escapeBytes_.data() + part * detail::packedEscapePayloadBytes };
+        detail::storeBytes(slot.word0, payload, 8);
+        detail::storeBytes(slot.word1, payload + 8, 7);
+        if (++escapeParts_ < escapedSlotCount)
+        {
+            return false;
+        }
+        escapeParts_ = 0;
+        std::memcpy(&out, escapeBytes_.data(), sizeof(out));
+        return true;
+    }
+
+private:
+    void unpack(const packedInputEvent& slot, inputEvent& out) const
+    {
+        out.sourceTimestampNs = epochNs_ + detail::bitField(slot.word0, 0, 48);
+        out.receiveTimestampNs = out.sourceTimestampNs + detail::bitField(slot.word1, 38, 25);
+        out.virtualKey = static_cast<std::uint32_t>(detail::bitField(slot.word0, 48, 8));
+        out.deviceId = static_cast<std::uint32_t>(detail::bitField(slot.word0, 56, 6));
+        out.isExtended = detail::bitField(slot.word0, 62, 1) != 0;
+        out.isTextEvent = detail::bitField(slot.word0, 63, 1) != 0;
+        out.scanCode = static_cast<std::uint32_t>(detail::bitField(slot.word1, 0, 12));
+        out.text = static_cast<char32_t>(detail::bitField(slot.word1, 12, 21));
+        out.kind = static_cast<eventKind>(detail::bitField(slot.word1, 33, 2));
+        out.device = static_cast<deviceType>(detail::bitField(slot.word1, 35, 2));
+        out.repeatCount = static_cast<std::uint16_t>(detail::bitField(slot.word1, 37, 1));
+    }
+
+    std::uint64_t epochNs_{};
+    std::array<std::uint8_t, escapedSlotCount * detail::packedEscapePayloadBytes> escapeBytes_{};
+    std::size_t escapeParts_{};
+    std::uint8_t escapeTag_{};
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCorePackedInputEventH
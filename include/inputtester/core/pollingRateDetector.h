@@ -0,0 +1,56 @@
+#ifndef inputTesterCorePollingRateDetectorH
+#define inputTesterCorePollingRateDetectorH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace inputTester
+{
+
+struct pollingRateEstimate
+{
+    std::uint32_t rateHz{};   // 0 until enough intervals fit one of the standard rates
+    std::uint64_t periodNs{};
+    double confidence{};      // 0..1
+    std::uint64_t intervals{}; // intervals considered so far
+    std::uint64_t gaps{};      // holes inside a continuous report stream
+    std::uint64_t missedPolls{};
+};
+
+// Finds which standard USB report rate (125 Hz .. 8 kHz) a device polls at from its event timestamps.
+// Reports only happen on poll boundaries, so every interval between reports is a whole number of poll
+// periods plus timestamping jitter; a candidate rate scores each interval by whether it lands on a
+// multiple of its period. Faster rates divide the true period and fit too, so the estimate is the
+// slowest candidate that still fits most intervals, and the confidence reflects how clearly the next
+// slower rate was ruled out. Scores are running averages over the last few hundred intervals.
+// O(candidates) per event with fixed state, so it keeps up with 8 kHz streams without allocating.
+class pollingRateDetector
+{
+public:
+    static constexpr std::array<std::uint32_t, 7> candidateRatesHz{ 125, 250, 500, 1'000, 2'000, 4'000, 8'000 };
+
+    // timestampNs must be non-decreasing; reports sharing a timestamp count once.
+    void record(std::uint64_t timestampNs) noexcept;
+
+    pollingRateEstimate estimate() const noexcept;
+
+    void reset() noexcept;
+
+private:
+    static constexpr std::size_t noCandidate{ candidateRatesHz.size() };
+
+    void recordInterval(std::uint64_t intervalNs) noexcept;
+    std::size_t bestCandidate() const noexcept;
+
+    std::array<double, candidateRatesHz.size()> fit_{};
+    std::uint64_t lastTimestampNs_{};
+    std::uint64_t intervals_{};
+    std::uint64_t gaps_{};
+    std::uint64_t missedPolls_{};
+    bool streaming_{ false }; // the previous interval was a single poll period
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCorePollingRateDetectorH
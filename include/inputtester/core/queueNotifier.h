@@ -0,0 +1,40 @@
+#ifndef inputTesterCoreQueueNotifierH
+#define inputTesterCoreQueueNotifierH
+
+namespace inputTester
+{
+
+// Pollable wakeup handle for a queue consumer (an eventfd on Linux). On platforms without eventfd
+// the notifier is invalid and callers keep polling on a timer.
+class queueNotifier
+{
+public:
+    queueNotifier();
+    ~queueNotifier();
+
+    queueNotifier(const queueNotifier&) = delete;
+    queueNotifier& operator=(const queueNotifier&) = delete;
+
+    bool isValid() const noexcept
+    {
+        return handle_ >= 0;
+    }
+
+    // File descriptor that becomes readable after signal(); -1 when invalid.
+    int handle() const noexcept
+    {
+        return handle_;
+    }
+
+    void signal() const noexcept;
+
+    // Clears the pending signal so the handle stops polling readable.
+    void acknowledge() const noexcept;
+
+private:
+    int handle_{ -1 };
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCoreQueueNotifierH
@@ -0,0 +1,62 @@
+#ifndef inputTesterCoreRingMemoryH
+#define inputTesterCoreRingMemoryH
+
+#include <cstddef>
+
+namespace inputTester
+{
+
+struct ringMemoryOptions
+{
+    bool lockPages{ false }; // mlock/VirtualLock so the ring never page-faults on the hot path
+    bool hugePages{ false }; // back with (transparent) huge pages where the platform supports it
+};
+
+// Owning, cache-line-aligned block for heap-backed ring buffers. Locking and huge pages are best
+// effort: if the OS refuses (e.g. RLIMIT_MEMLOCK), the block is still usable and the getters report it.
+class ringMemory
+{
+public:
+    ringMemory() = default;
+    ringMemory(std::size_t bytes, ringMemoryOptions options);
+    ~ringMemory();
+
+    ringMemory(const ringMemory&) = delete;
+    ringMemory& operator=(const ringMemory&) = delete;
+    ringMemory(ringMemory&& other) noexcept;
+    ringMemory& operator=(ringMemory&& other) noexcept;
+
+    void* data() const noexcept
+    {
+        return data_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    bool isLocked() const noexcept
+    {
+        return locked_;
+    }
+
+    // The kernel accepted the huge page advice; whether huge pages actually back the block is up to it.
+    bool hugePagesAdvised() const noexcept
+    {
+        return hugePagesAdvised_;
+    }
+
+private:
+    void release() noexcept;
+
+    void* data_{};
+    std::size_t size_{};
+    std::size_t mappedSize_{};
+    bool locked_{ false };
+    bool hugePagesAdvised_{ false };
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCoreRingMemoryH
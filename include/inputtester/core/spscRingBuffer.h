@@ -1,30 +1,134 @@
 #ifndef inputTesterCoreSpscRingBufferH
 #define inputTesterCoreSpscRingBufferH
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <type_traits>
 
+#include "inputtester/core/ringMemory.h"
+
 namespace inputTester
 {
 
-template <typename T, std::size_t bufferCapacity> class spscRingBuffer
+// shared: every operation acquires the other side's index, so both index lines bounce between cores.
+// cached: each side keeps a private copy of the other side's index and reloads it only when the ring
+// looks full (producer) or empty (consumer).
+enum class spscIndexPolicy : std::uint8_t
+{
+    shared = 0,
+    cached,
+};
+
+// Pass as bufferCapacity to size the ring at construction time instead of at compile time.
+inline constexpr std::size_t dynamicCapacity{ 0 };
+
+namespace detail
+{
+
+template <typename T, std::size_t bufferCapacity> class spscRingStorage
 {
     static_assert(bufferCapacity >= 2, "bufferCapacity must be at least 2");
     static_assert((bufferCapacity & (bufferCapacity - 1)) == 0, "bufferCapacity must be power of two");
+
+public:
+    T* data() noexcept
+    {
+        return items_.data();
+    }
+
+    const T* data() const noexcept
+    {
+        return items_.data();
+    }
+
+    static constexpr std::size_t capacity() noexcept
+    {
+        return bufferCapacity;
+    }
+
+    static constexpr bool isLocked() noexcept
+    {
+        return false;
+    }
+
+private:
+    std::array<T, bufferCapacity> items_{};
+};
+
+// Heap-backed storage: the requested capacity is rounded up to a power of two (at least 2).
+template <typename T> class spscRingStorage<T, dynamicCapacity>
+{
+public:
+    spscRingStorage(std::size_t requestedCapacity, ringMemoryOptions options)
+        : capacity_{ std::bit_ceil(std::max<std::size_t>(requestedCapacity, 2)) },
+          memory_{ capacity_ * sizeof(T), options }, items_{ static_cast<T*>(memory_.data()) }
+    {
+        // Touches every page up front, so a locked ring is fully resident before the first push.
+        std::uninitialized_value_construct_n(items_, capacity_);
+    }
+
+    T* data() noexcept
+    {
+        return items_;
+    }
+
+    const T* data() const noexcept
+    {
+        return items_;
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    bool isLocked() const noexcept
+    {
+        return memory_.isLocked();
+    }
+
+private:
+    std::size_t capacity_{};
+    ringMemory memory_{};
+    T* items_{};
+};
+
+} // namespace detail
+
+template <typename T, std::size_t bufferCapacity, spscIndexPolicy indexPolicy = spscIndexPolicy::shared>
+class spscRingBuffer
+{
     static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
 
 public:
+    spscRingBuffer()
+        requires(bufferCapacity != dynamicCapacity)
+    = default;
+
+    explicit spscRingBuffer(std::size_t requestedCapacity, ringMemoryOptions options = {})
+        requires(bufferCapacity == dynamicCapacity)
+        : storage_{ requestedCapacity, options }
+    {
+    }
+
+    spscRingBuffer(const spscRingBuffer&) = delete;
+    spscRingBuffer& operator=(const spscRingBuffer&) = delete;
+
     bool tryPush(const T& item) noexcept
     {
         const auto headIndex{ head_.load(std::memory_order_relaxed) };
-        const auto tailIndex{ tail_.load(std::memory_order_acquire) };
+        const auto tailIndex{ tailForPush(headIndex, 1) };
         if (isFull(headIndex, tailIndex))
         {
             return false;
         }
-        buffer_[indexFor(headIndex)] = item;
+        storage_.data()[indexFor(headIndex)] = item;
         head_.store(headIndex + 1, std::memory_order_release);
         return true;
     }
@@ -32,28 +136,190 @@ public:
     bool tryPop(T& out) noexcept
     {
         const auto tailIndex{ tail_.load(std::memory_order_relaxed) };
-        const auto headIndex{ head_.load(std::memory_order_acquire) };
+        const auto headIndex{ headForPop(tailIndex, 1) };
         if (isEmpty(headIndex, tailIndex))
         {
             return false;
         }
-        out = buffer_[indexFor(tailIndex)];
+        out = storage_.data()[indexFor(tailIndex)];
         tail_.store(tailIndex + 1, std::memory_order_release);
         return true;
     }
 
+    // Returns the next free slot for the producer to fill in place, or nullptr when full.
+    // The slot becomes visible to the consumer only after commit().
+    T* reserve() noexcept
+    {
+        const auto headIndex{ head_.load(std::memory_order_relaxed) };
+        const auto tailIndex{ tailForPush(headIndex, 1) };
+        if (isFull(headIndex, tailIndex))
+        {
+            return nullptr;
+        }
+        return &storage_.data()[indexFor(headIndex)];
+    }
+
+    void commit() noexcept
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Returns the contiguous run of readable slots (up to the wrap point) without copying.
+    // The slots stay owned by the consumer until release(count).
+    std::span<const T> peek() noexcept
+    {
+        const auto tailIndex{ tail_.load(std::memory_order_relaxed) };
+        const auto headIndex{ headForPop(tailIndex, 1) };
+        const auto first{ indexFor(tailIndex) };
+        const auto count{ std::min(headIndex - tailIndex, capacity() - first) };
+        return std::span<const T>{ storage_.data() + first, count };
+    }
+
+    void release(std::size_t count) noexcept
+    {
+        tail_.store(tail_.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Pushes as many items as fit and publishes them with a single release store.
+    std::size_t tryPushBatch(std::span<const T> items) noexcept
+    {
+        const auto headIndex{ head_.load(std::memory_order_relaxed) };
+        const auto tailIndex{ tailForPush(headIndex, items.size()) };
+        const auto count{ std::min(items.size(), capacity() - (headIndex - tailIndex)) };
+        if (count == 0)
+        {
+            return 0;
+        }
+        publishRun(headIndex, items.first(count));
+        return count;
+    }
+
+    // Pushes all items or none, so the consumer never sees part of a multi-slot record.
+    bool tryPushAll(std::span<const T> items) noexcept
+    {
+        const auto headIndex{ head_.load(std::memory_order_relaxed) };
+        const auto tailIndex{ tailForPush(headIndex, items.size()) };
+        if (capacity() - (headIndex - tailIndex) < items.size())
+        {
+            return false;
+        }
+        publishRun(headIndex, items);
+        return true;
+    }
+
+    // Pops up to out.size() items and releases their slots with a single release store.
+    std::size_t tryPopBatch(std::span<T> out) noexcept
+    {
+        const auto tailIndex{ tail_.load(std::memory_order_relaxed) };
+        const auto headIndex{ headForPop(tailIndex, out.size()) };
+        const auto count{ std::min(out.size(), headIndex - tailIndex) };
+        if (count == 0)
+        {
+            return 0;
+        }
+        const auto first{ indexFor(tailIndex) };
+        const auto firstChunk{ std::min(count, capacity() - first) };
+        std::copy_n(storage_.data() + first, firstChunk, out.begin());
+        std::copy_n(storage_.data(), count - firstChunk, out.begin() + firstChunk);
+        tail_.store(tailIndex + count, std::memory_order_release);
+        return count;
+    }
+
+    // Evicting pair for overwrite-oldest queues. The producer may advance tail_ itself to drop the
+    // oldest item when full, so an evicting consumer must copy out and confirm with a CAS on tail_;
+    // a failed CAS means the slot was evicted (and possibly rewritten) mid-copy and the copy is
+    // discarded. Do not mix with tryPop/peek/release on the same ring.
+    // Evicts only while fewer than `wanted` slots are free.
+    bool tryEvictOldest(std::size_t wanted = 1) noexcept
+    {
+        auto tailIndex{ tail_.load(std::memory_order_acquire) };
+        const auto headIndex{ head_.load(std::memory_order_relaxed) };
+        if (capacity() - (headIndex - tailIndex) >= wanted)
+        {
+            return false;
+        }
+        return tail_.compare_exchange_strong(tailIndex, tailIndex + 1, std::memory_order_acq_rel,
+                                             std::memory_order_acquire);
+    }
+
+    bool tryPopEvictable(T& out) noexcept
+    {
+        auto tailIndex{ tail_.load(std::memory_order_acquire) };
+        for (;;)
+        {
+            const auto headIndex{ head_.load(std::memory_order_acquire) };
+            if (isEmpty(headIndex, tailIndex))
+            {
+                return false;
+            }
+            out = storage_.data()[indexFor(tailIndex)];
+            if (tail_.compare_exchange_strong(tailIndex, tailIndex + 1, std::memory_order_acq_rel,
+                                              std::memory_order_acquire))
+            {
+                return true;
+            }
+        }
+    }
+
+    // Producer: whether count more items fit, so the caller can prepare side data for them before pushing.
+    bool hasRoomFor(std::size_t count) noexcept
+    {
+        const auto headIndex{ head_.load(std::memory_order_relaxed) };
+        return capacity() - (headIndex - tailForPush(headIndex, count)) >= count;
+    }
+
+    // Items ever pushed (producer side) and popped (consumer side); the next item lands in, or is read from,
+    // slot count & (capacity() - 1).
+    std::size_t pushedCount() const noexcept
+    {
+        return head_.load(std::memory_order_relaxed);
+    }
+
+    std::size_t poppedCount() const noexcept
+    {
+        return tail_.load(std::memory_order_relaxed);
+    }
+
+    // Approximate fill level; exact when called from the consumer with no concurrent eviction.
+    std::size_t size() const noexcept
+    {
+        const auto tailIndex{ tail_.load(std::memory_order_acquire) };
+        const auto headIndex{ head_.load(std::memory_order_acquire) };
+        return std::min(headIndex - tailIndex, capacity());
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return storage_.capacity();
+    }
+
+    // True when the backing pages are pinned in RAM (dynamic rings built with lockPages only).
+    bool isLocked() const noexcept
+    {
+        return storage_.isLocked();
+    }
+
     void reset() noexcept
     {
         head_.store(0, std::memory_order_relaxed);
         tail_.store(0, std::memory_order_relaxed);
+        cachedTail_ = 0;
+        cachedHead_ = 0;
     }
 
 private:
-    static constexpr std::size_t indexMask{ bufferCapacity - 1 };
+    std::size_t indexFor(std::size_t absoluteIndex) const noexcept
+    {
+        return absoluteIndex & (capacity() - 1);
+    }
 
-    static constexpr std::size_t indexFor(std::size_t absoluteIndex) noexcept
+    void publishRun(std::size_t headIndex, std::span<const T> items) noexcept
     {
-        return absoluteIndex & indexMask;
+        const auto first{ indexFor(headIndex) };
+        const auto firstChunk{ std::min(items.size(), capacity() - first) };
+        std::copy_n(items.begin(), firstChunk, storage_.data() + first);
+        std::copy_n(items.begin() + firstChunk, items.size() - firstChunk, storage_.data());
+        head_.store(headIndex + items.size(), std::memory_order_release);
     }
 
     static constexpr bool isEmpty(std::size_t headIndex, std::size_t tailIndex) noexcept
@@ -61,14 +327,50 @@ private:
         return headIndex == tailIndex;
     }
 
-    static constexpr bool isFull(std::size_t headIndex, std::size_t tailIndex) noexcept
+    bool isFull(std::size_t headIndex, std::size_t tailIndex) const noexcept
     {
-        return (headIndex - tailIndex) == bufferCapacity;
+        return (headIndex - tailIndex) == capacity();
+    }
+
+    // Producer view of tail_; the cached policy reloads only when fewer than `wanted` slots look free.
+    std::size_t tailForPush(std::size_t headIndex, std::size_t wanted) noexcept
+    {
+        if constexpr (indexPolicy == spscIndexPolicy::cached)
+        {
+            if (capacity() - (headIndex - cachedTail_) < wanted)
+            {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+            }
+            return cachedTail_;
+        }
+        else
+        {
+            return tail_.load(std::memory_order_acquire);
+        }
+    }
+
+    // Consumer view of head_; the cached policy reloads only when fewer than `wanted` items look ready.
+    std::size_t headForPop(std::size_t tailIndex, std::size_t wanted) noexcept
+    {
+        if constexpr (indexPolicy == spscIndexPolicy::cached)
+        {
+            if (cachedHead_ - tailIndex < wanted)
+            {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+            }
+            return cachedHead_;
+        }
+        else
+        {
+            return head_.load(std::memory_order_acquire);
+        }
     }
 
     alignas(64) std::atomic<std::size_t> head_{};
+    alignas(64) std::size_t cachedTail_{}; // producer-private
     alignas(64) std::atomic<std::size_t> tail_{};
-    std::array<T, bufferCapacity> buffer_{};
+    alignas(64) std::size_t cachedHead_{}; // consumer-private
+    alignas(64) detail::spscRingStorage<T, bufferCapacity> storage_{};
 };
 
 } // namespace inputTester
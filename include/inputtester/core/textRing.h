@@ -0,0 +1,74 @@
+#ifndef inputTesterCoreTextRingH
+#define inputTesterCoreTextRingH
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace inputTester
+{
+
+// What changed in a textRing since the previous takeDelta(), in the terms a text widget edits by: UTF-16 units to
+// cut from the start and from the end of what it shows, then code points [appendFrom, size()) to append.
+struct textRingDelta
+{
+    std::size_t removeFrontUnits{};
+    std::size_t removeBackUnits{};
+    std::size_t appendFrom{};
+};
+
+// Fixed-capacity ring of the most recently typed code points. Pushing into a full ring drops the oldest one,
+// backspace removes the newest; neither allocates after construction. Edits accumulate until takeDelta(), so a
+// view can be brought up to date once per frame at a cost proportional to the characters that changed.
+class textRing
+{
+public:
+    explicit textRing(std::size_t capacity);
+
+    void push(char32_t codePoint) noexcept;
+    // Returns false when the ring is already empty.
+    bool backspace() noexcept;
+    void clear() noexcept;
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return codePoints_.size();
+    }
+
+    // index 0 is the oldest code point still held.
+    char32_t at(std::size_t index) const noexcept
+    {
+        return codePoints_[(head_ + index) % codePoints_.size()];
+    }
+
+    bool hasPendingChanges() const noexcept
+    {
+        return pendingFrontUnits_ != 0 || pendingBackUnits_ != 0 || shown_ != size_;
+    }
+
+    // The edit that turns the text shown at the previous takeDelta() into the current contents.
+    textRingDelta takeDelta() noexcept;
+
+    static std::size_t utf16Units(char32_t codePoint) noexcept
+    {
+        return codePoint > 0xFFFF ? 2 : 1;
+    }
+
+private:
+    std::vector<char32_t> codePoints_;
+    std::size_t head_{};
+    std::size_t size_{};
+    // The first shown_ code points are on screen unchanged; anything after them is waiting to be appended.
+    std::size_t shown_{};
+    std::size_t pendingFrontUnits_{};
+    std::size_t pendingBackUnits_{};
+};
+
+} // namespace inputTester
+
+#endif // inputTesterCoreTextRingH
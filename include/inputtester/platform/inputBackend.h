@@ -1,6 +1,7 @@
 #ifndef inputTesterPlatformInputBackendH
 #define inputTesterPlatformInputBackendH
 
+#include <cstdint>
 #include <memory>
 
 #include <QString>
@@ -19,10 +20,21 @@ public:
     virtual bool start(QObject* eventSource, QString* errorMessage) = 0;
     virtual void stop() = 0;
     virtual void setSink(inputEventSink* sink) = 0;
+    // Times the device or kernel lost input before the backend read it (evdev SYN_DROPPED); 0 where the
+    // backend cannot tell. Any thread.
+    virtual std::uint64_t overrunCount() const
+    {
+        return 0;
+    }
 };
 
 std::unique_ptr<inputBackend> createInputBackend();
 
+#if defined(__linux__)
+// Reads /dev/input/event* directly on a dedicated thread instead of through Qt key events.
+std::unique_ptr<inputBackend> createEvdevInputBackend();
+#endif
+
 } // namespace inputTester
 
 #endif // inputTesterPlatformInputBackendH
@@ -0,0 +1,649 @@
+#include "inputtester/core/blockWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace inputTester
+{
+
+namespace
+{
+
+void setError(std::string* errorMessage, const std::string& message)
+{
+    if (errorMessage != nullptr)
+    {
+        *errorMessage = message;
+    }
+}
+
+#ifdef _WIN32
+std::string lastErrorText()
+{
+    return "Windows error " + std::to_string(GetLastError());
+}
+
+HANDLE toHandle(std::intptr_t handle)
+{
+    return reinterpret_cast<HANDLE>(handle);
+}
+#endif
+
+} // namespace
+
+outputFile::~outputFile()
+{
+    close();
+}
+
+bool outputFile::open(const std::string& path, std::string* errorMessage)
+{
+    close();
+#ifdef _WIN32
+    const HANDLE handle{ CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                                     FILE_ATTRIBUTE_NORMAL, nullptr) };
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        setError(errorMessage, path + ": " + lastErrorText());
+        return false;
+    }
+    handle_ = reinterpret_cast<std::intptr_t>(handle);
+#else
+    const int descriptor{ ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) };
+    if (descriptor < 0)
+    {
+        setError(errorMessage, path + ": " + std::strerror(errno));
+        return false;
+    }
+    handle_ = descriptor;
+#endif
+    return true;
+}
+
+bool outputFile::close(std::string* errorMessage)
+{
+    if (!isOpen())
+    {
+        return true;
+    }
+#ifdef _WIN32
+    const bool closed{ CloseHandle(toHandle(handle_)) != 0 };
+    if (!closed)
+    {
+        setError(errorMessage, lastErrorText());
+    }
+#else
+    const bool closed{ ::close(static_cast<int>(handle_)) == 0 };
+    if (!closed)
+    {
+        setError(errorMessage, std::strerror(errno));
+    }
+#endif
+    handle_ = invalidHandle;
+    return closed;
+}
+
+bool outputFile::writeAt(const void* data, std::size_t bytes, std::uint64_t offset, std::string* errorMessage)
+{
+    const auto* cursor{ static_cast<const std::uint8_t*>(data) };
+    while (bytes != 0)
+    {
+#ifdef _WIN32
+        OVERLAPPED position{};
+        position.Offset = static_cast<DWORD>(offset);
+        position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD written{};
+        const auto chunk{ static_cast<DWORD>(std::min<std::size_t>(bytes, 1U << 30)) };
+        if (WriteFile(toHandle(handle_), cursor, chunk, &written, &position) == 0 || written == 0)
+        {
+            setError(errorMessage, lastErrorText());
+            return false;
+        }
+#else
+        const auto written{ ::pwrite(static_cast<int>(handle_), cursor, bytes, static_cast<off_t>(offset)) };
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            setError(errorMessage, written < 0 ? std::strerror(errno) : "short write");
+            return false;
+        }
+#endif
+        cursor += written;
+        bytes -= static_cast<std::size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+    return true;
+}
+
+blockWriter::blockWriter(outputFile& file, std::size_t blockBytes, std::size_t bufferCount)
+    : file_{ file }, blockBytes_{ blockBytes }
+{
+    const auto count{ std::max<std::size_t>(bufferCount, 1) };
+    buffers_.reserve(count);
+    freeBuffers_.reserve(count);
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        buffers_.emplace_back(blockBytes_, ringMemoryOptions{});
+        freeBuffers_.push_back(index);
+    }
+}
+
+blockWriter::~blockWriter() = default;
+
+std::span<std::byte> blockWriter::acquire()
+{
+    pollCompletions();
+    std::size_t index{};
+    if (!takeFreeBuffer(index))
+    {
+        stalls_.fetch_add(1, std::memory_order_relaxed);
+        do
+        {
+            waitForCompletion();
+            pollCompletions();
+        } while (!takeFreeBuffer(index));
+    }
+    return { bufferData(index), blockBytes_ };
+}
+
+void blockWriter::submit(std::span<std::byte> buffer, std::size_t bytes, std::uint64_t offset)
+{
+    std::size_t index{};
+    if (!indexOf(buffer, index))
+    {
+        const std::lock_guard lock{ poolMutex_ };
+        if (!failed_.exchange(true, std::memory_order_relaxed))
+        {
+            error_ = "submitted a buffer the writer does not own";
+        }
+        return;
+    }
+    if (bytes == 0 || failed_.load(std::memory_order_relaxed))
+    {
+        const std::lock_guard lock{ poolMutex_ };
+        freeBuffers_.push_back(index);
+        return;
+    }
+    const auto inFlight{ inFlight_.fetch_add(1, std::memory_order_relaxed) + 1 };
+    if (inFlight > peakInFlight_.load(std::memory_order_relaxed))
+    {
+        peakInFlight_.store(inFlight, std::memory_order_relaxed);
+    }
+    startWrite(index, std::min(bytes, blockBytes_), offset);
+}
+
+bool blockWriter::flush(std::string* errorMessage)
+{
+    while (inFlight_.load(std::memory_order_acquire) != 0)
+    {
+        pollCompletions();
+        if (inFlight_.load(std::memory_order_acquire) != 0)
+        {
+            waitForCompletion();
+        }
+    }
+    if (failed_.load(std::memory_order_relaxed))
+    {
+        const std::lock_guard lock{ poolMutex_ };
+        setError(errorMessage, error_);
+        return false;
+    }
+    return true;
+}
+
+blockWriterStats blockWriter::stats() const
+{
+    blockWriterStats result{};
+    result.bytesWritten = bytesWritten_.load(std::memory_order_relaxed);
+    result.blocksWritten = blocksWritten_.load(std::memory_order_relaxed);
+    result.inFlight = inFlight_.load(std::memory_order_relaxed);
+    result.peakInFlight = peakInFlight_.load(std::memory_order_relaxed);
+    result.stalls = stalls_.load(std::memory_order_relaxed);
+    result.failed = failed_.load(std::memory_order_relaxed);
+    return result;
+}
+
+void blockWriter::reset()
+{
+    {
+        const std::lock_guard lock{ poolMutex_ };
+        error_.clear();
+    }
+    failed_.store(false, std::memory_order_relaxed);
+    bytesWritten_.store(0, std::memory_order_relaxed);
+    blocksWritten_.store(0, std::memory_order_relaxed);
+    peakInFlight_.store(inFlight_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    stalls_.store(0, std::memory_order_relaxed);
+}
+
+void blockWriter::completeWrite(std::size_t index, std::size_t bytes, const char* error)
+{
+    {
+        const std::lock_guard lock{ poolMutex_ };
+        if (error != nullptr)
+        {
+            if (!failed_.exchange(true, std::memory_order_relaxed))
+            {
+                error_ = error;
+            }
+        }
+        else
+        {
+            bytesWritten_.fetch_add(bytes, std::memory_order_relaxed);
+            blocksWritten_.fetch_add(1, std::memory_order_relaxed);
+        }
+        freeBuffers_.push_back(index);
+    }
+    inFlight_.fetch_sub(1, std::memory_order_release);
+}
+
+bool blockWriter::takeFreeBuffer(std::size_t& index)
+{
+    const std::lock_guard lock{ poolMutex_ };
+    if (freeBuffers_.empty())
+    {
+        return false;
+    }
+    index = freeBuffers_.back();
+    freeBuffers_.pop_back();
+    return true;
+}
+
+bool blockWriter::indexOf(std::span<std::byte> buffer, std::size_t& index) const
+{
+    for (index = 0; index < buffers_.size(); ++index)
+    {
+        if (buffers_[index].data() == buffer.data())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+namespace
+{
+
+// Blocking positional writes on a worker thread, in submission order.
+class threadBlockWriter final : public blockWriter
+{
+public:
+    threadBlockWriter(outputFile& file, std::size_t blockBytes, std::size_t bufferCount)
+        : blockWriter{ file, blockBytes, bufferCount }, jobs_(this->bufferCount()),
+          worker_{ [this]() { run(); } }
+    {
+    }
+
+    ~threadBlockWriter() override
+    {
+        {
+            const std::lock_guard lock{ mutex_ };
+            stop_ = true;
+        }
+        workAvailable_.notify_one();
+        worker_.join();
+    }
+
+    blockWriterBackend backend() const noexcept override
+    {
+        return blockWriterBackend::thread;
+    }
+
+protected:
+    void startWrite(std::size_t index, std::size_t bytes, std::uint64_t offset) override
+    {
+        {
+            const std::lock_guard lock{ mutex_ };
+            // At most one job per buffer, so the ring never overflows.
+            jobs_[(firstJob_ + jobCount_) % jobs_.size()] = { index, bytes, offset };
+            ++jobCount_;
+        }
+        workAvailable_.notify_one();
+    }
+
+    void waitForCompletion() override
+    {
+        std::unique_lock lock{ mutex_ };
+        writeCompleted_.wait(lock, [this]() { return completions_ != seenCompletions_; });
+        seenCompletions_ = completions_;
+    }
+
+private:
+    struct job
+    {
+        std::size_t index{};
+        std::size_t bytes{};
+        std::uint64_t offset{};
+    };
+
+    void run()
+    {
+        for (;;)
+        {
+            job next{};
+            {
+                std::unique_lock lock{ mutex_ };
+                workAvailable_.wait(lock, [this]() { return stop_ || jobCount_ != 0; });
+                if (jobCount_ == 0)
+                {
+                    return;
+                }
+                next = jobs_[firstJob_];
+                firstJob_ = (firstJob_ + 1) % jobs_.size();
+                --jobCount_;
+            }
+            std::string error{};
+            const bool written{ file().writeAt(bufferData(next.index), next.bytes, next.offset, &error) };
+            completeWrite(next.index, next.bytes, written ? nullptr : error.c_str());
+            {
+                const std::lock_guard lock{ mutex_ };
+                ++completions_;
+            }
+            writeCompleted_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable writeCompleted_;
+    std::vector<job> jobs_;
+    std::size_t firstJob_{};
+    std::size_t jobCount_{};
+    std::uint64_t completions_{};
+    std::uint64_t seenCompletions_{};
+    bool stop_{ false };
+    std::thread worker_;
+};
+
+#if defined(__linux__)
+
+int ioUringSetup(unsigned entries, io_uring_params* params)
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    for (;;)
+    {
+        const auto result{ static_cast<int>(
+            syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, std::size_t{ 0 })) };
+        if (result >= 0 || errno != EINTR)
+        {
+            return result;
+        }
+    }
+}
+
+// One submission queue entry per buffer, driven through the raw io_uring syscalls. The producer thread both
+// submits and reaps, so no other thread is involved; a write the kernel completes short is resubmitted for the
+// rest. IORING_OP_WRITEV keeps this working on kernels from 5.1 on.
+class ioUringBlockWriter final : public blockWriter
+{
+public:
+    ioUringBlockWriter(outputFile& file, std::size_t blockBytes, std::size_t bufferCount)
+        : blockWriter{ file, blockBytes, bufferCount }, writes_(this->bufferCount())
+    {
+        io_uring_params params{};
+        ringFd_ = ioUringSetup(static_cast<unsigned>(this->bufferCount()), &params);
+        if (ringFd_ < 0)
+        {
+            return;
+        }
+        sqRingBytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingBytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap{ (params.features & IORING_FEAT_SINGLE_MMAP) != 0 };
+        if (singleMap)
+        {
+            sqRingBytes_ = std::max(sqRingBytes_, cqRingBytes_);
+        }
+        sqRing_ = mapRing(sqRingBytes_, IORING_OFF_SQ_RING);
+        cqRing_ = singleMap ? sqRing_ : mapRing(cqRingBytes_, IORING_OFF_CQ_RING);
+        sqesBytes_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes{ mapRing(sqesBytes_, IORING_OFF_SQES) };
+        if (sqRing_ == nullptr || cqRing_ == nullptr || sqes == nullptr)
+        {
+            if (sqes != nullptr)
+            {
+                munmap(sqes, sqesBytes_);
+            }
+            releaseRing();
+            return;
+        }
+        auto* sqBase{ static_cast<std::uint8_t*>(sqRing_) };
+        auto* cqBase{ static_cast<std::uint8_t*>(cqRing_) };
+        sqHead_ = reinterpret_cast<unsigned*>(sqBase + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sqBase + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sqBase + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sqBase + params.sq_off.array);
+        cqHead_ = reinterpret_cast<unsigned*>(cqBase + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cqBase + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cqBase + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cqBase + params.cq_off.cqes);
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+    }
+
+    ~ioUringBlockWriter() override
+    {
+        // The kernel may still be reading the buffers.
+        if (isReady())
+        {
+            flush();
+            munmap(sqes_, sqesBytes_);
+        }
+        releaseRing();
+    }
+
+    bool isReady() const noexcept
+    {
+        return sqes_ != nullptr;
+    }
+
+    blockWriterBackend backend() const noexcept override
+    {
+        return blockWriterBackend::ioUring;
+    }
+
+protected:
+    void startWrite(std::size_t index, std::size_t bytes, std::uint64_t offset) override
+    {
+        writes_[index] = { {}, bytes, 0, offset };
+        queueWrite(index);
+    }
+
+    void waitForCompletion() override
+    {
+        if (reap() == 0)
+        {
+            submitQueued(1, IORING_ENTER_GETEVENTS);
+            reap();
+        }
+    }
+
+    void pollCompletions() override
+    {
+        reap();
+        if (queuedEntries() != 0)
+        {
+            submitQueued(0, 0);
+        }
+    }
+
+private:
+    struct pendingWrite
+    {
+        iovec vector{};
+        std::size_t bytes{};
+        std::size_t written{};
+        std::uint64_t offset{};
+    };
+
+    void* mapRing(std::size_t bytes, off_t offset) const
+    {
+        void* mapped{ mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, offset) };
+        return mapped == MAP_FAILED ? nullptr : mapped;
+    }
+
+    void releaseRing() noexcept
+    {
+        if (cqRing_ != nullptr && cqRing_ != sqRing_)
+        {
+            munmap(cqRing_, cqRingBytes_);
+        }
+        if (sqRing_ != nullptr)
+        {
+            munmap(sqRing_, sqRingBytes_);
+        }
+        if (ringFd_ >= 0)
+        {
+            ::close(ringFd_);
+        }
+        cqRing_ = nullptr;
+        sqRing_ = nullptr;
+        sqes_ = nullptr;
+        ringFd_ = -1;
+    }
+
+    // Submits the unwritten remainder of buffer index.
+    void queueWrite(std::size_t index)
+    {
+        auto& write{ writes_[index] };
+        write.vector.iov_base = bufferData(index) + write.written;
+        write.vector.iov_len = write.bytes - write.written;
+
+        // Only this thread moves the tail, so it can be read plainly; the kernel reads it with acquire.
+        const auto tail{ *sqTail_ };
+        const auto slot{ tail & sqMask_ };
+        auto& entry{ sqes_[slot] };
+        entry = io_uring_sqe{};
+        entry.opcode = IORING_OP_WRITEV;
+        entry.fd = static_cast<int>(file().nativeHandle());
+        entry.addr = reinterpret_cast<std::uint64_t>(&write.vector);
+        entry.len = 1;
+        entry.off = write.offset + write.written;
+        entry.user_data = index;
+        sqArray_[slot] = slot;
+        std::atomic_ref<unsigned>{ *sqTail_ }.store(tail + 1, std::memory_order_release);
+        submitQueued(0, 0);
+    }
+
+    // Entries published to the submission queue that the kernel has not consumed yet.
+    unsigned queuedEntries() const
+    {
+        return *sqTail_ - std::atomic_ref<unsigned>{ *sqHead_ }.load(std::memory_order_acquire);
+    }
+
+    // Hands the kernel every queued entry. When it refuses for now (EAGAIN, or EBUSY while the completion queue is
+    // full) the entries stay queued and the next poll or wait submits them again. Any other error means they will
+    // never be consumed, so the tail is rolled back over them before their writes fail; completing a write whose
+    // entry is still queued would complete it twice.
+    void submitQueued(unsigned minComplete, unsigned flags)
+    {
+        if (ioUringEnter(ringFd_, queuedEntries(), minComplete, flags) >= 0 || errno == EAGAIN || errno == EBUSY)
+        {
+            return;
+        }
+        const char* error{ std::strerror(errno) };
+        // Without SQPOLL the kernel only reads the submission queue inside io_uring_enter, so the head is settled.
+        const auto tail{ *sqTail_ };
+        const auto head{ std::atomic_ref<unsigned>{ *sqHead_ }.load(std::memory_order_acquire) };
+        std::atomic_ref<unsigned>{ *sqTail_ }.store(head, std::memory_order_release);
+        for (auto position = head; position != tail; ++position)
+        {
+            const auto index{ static_cast<std::size_t>(sqes_[position & sqMask_].user_data) };
+            completeWrite(index, writes_[index].written, error);
+        }
+    }
+
+    std::size_t reap()
+    {
+        auto head{ *cqHead_ };
+        const auto tail{ std::atomic_ref<unsigned>{ *cqTail_ }.load(std::memory_order_acquire) };
+        std::size_t reaped{ 0 };
+        for (; head != tail; ++head, ++reaped)
+        {
+            const auto& completion{ cqes_[head & cqMask_] };
+            const auto index{ static_cast<std::size_t>(completion.user_data) };
+            const auto result{ completion.res };
+            // Release the entry before a resubmission can need the space.
+            std::atomic_ref<unsigned>{ *cqHead_ }.store(head + 1, std::memory_order_release);
+            auto& write{ writes_[index] };
+            if (result <= 0)
+            {
+                completeWrite(index, write.written, result < 0 ? std::strerror(-result) : "short write");
+                continue;
+            }
+            write.written += static_cast<std::size_t>(result);
+            if (write.written < write.bytes)
+            {
+                queueWrite(index);
+                continue;
+            }
+            completeWrite(index, write.bytes, nullptr);
+        }
+        return reaped;
+    }
+
+    std::vector<pendingWrite> writes_; // by buffer index; each iovec must stay put until its write completes
+    int ringFd_{ -1 };
+    void* sqRing_{};
+    void* cqRing_{};
+    std::size_t sqRingBytes_{};
+    std::size_t cqRingBytes_{};
+    std::size_t sqesBytes_{};
+    unsigned* sqHead_{};
+    unsigned* sqTail_{};
+    unsigned sqMask_{};
+    unsigned* sqArray_{};
+    unsigned* cqHead_{};
+    unsigned* cqTail_{};
+    unsigned cqMask_{};
+    io_uring_cqe* cqes_{};
+    io_uring_sqe* sqes_{};
+};
+
+#endif
+
+} // namespace
+
+std::unique_ptr<blockWriter> blockWriter::create(outputFile& file, std::size_t blockBytes, std::size_t bufferCount,
+                                                 blockWriterBackend preferred)
+{
+#if defined(__linux__)
+    if (preferred == blockWriterBackend::ioUring)
+    {
+        // Falls back when the kernel is too old or io_uring is disabled (sysctl, seccomp in containers).
+        auto ring{ std::make_unique<ioUringBlockWriter>(file, blockBytes, bufferCount) };
+        if (ring->isReady())
+        {
+            return ring;
+        }
+    }
+#else
+    static_cast<void>(preferred);
+#endif
+    return std::make_unique<threadBlockWriter>(file, blockBytes, bufferCount);
+}
+
+} // namespace inputTester
@@ -0,0 +1,379 @@
+#include "inputtester/core/captureFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace inputTester
+{
+
+namespace
+{
+
+constexpr std::size_t g_pageSize{ 4'096 };
+// Events stamped slightly before the file was opened (source clocks, queued input) still pack into one slot.
+constexpr std::uint64_t g_epochMarginNs{ 1'000'000'000 };
+
+void setError(std::string* errorMessage, const std::string& message)
+{
+    if (errorMessage != nullptr)
+    {
+        *errorMessage = message;
+    }
+}
+
+std::uint64_t wallClockNowNs()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::system_clock::now().time_since_epoch())
+                                          .count());
+}
+
+} // namespace
+
+captureWriter::captureWriter(captureWriterOptions options)
+    : options_{ options }, queue_{ options.maxProducers, overflowPolicy::dropNewest, options.capacityPerLane },
+      blocks_{ blockWriter::create(file_, std::max<std::size_t>(options.blockBytes / g_pageSize, 1) * g_pageSize,
+                                   std::max<std::size_t>(options.blockCount, 2), options.backend) }
+{
+}
+
+captureWriter::~captureWriter()
+{
+    close();
+}
+
+bool captureWriter::open(const std::string& path, std::string* errorMessage)
+{
+    if (isOpen())
+    {
+        setError(errorMessage, "a capture is already being recorded");
+        return false;
+    }
+    if (!file_.open(path, errorMessage))
+    {
+        return false;
+    }
+
+    // Whatever producers queued after the previous close belongs to no file.
+    queue_.drain([](const inputEvent&) {});
+    const auto nowNs{ nowTimestampNs() };
+    header_ = captureFileHeader{};
+    header_.epochNs = nowNs > g_epochMarginNs ? nowNs - g_epochMarginNs : 0;
+    header_.wallClockNs = wallClockNowNs() - (nowNs - header_.epochNs);
+    encoder_ = packedEventEncoder{ header_.epochNs };
+    deviceCount_ = 0;
+    eventsWritten_.store(0, std::memory_order_relaxed);
+
+    std::array<std::uint8_t, captureFileHeader::defaultRecordsOffset> page{};
+    std::memcpy(page.data(), &header_, sizeof(header_));
+    if (!file_.writeAt(page.data(), page.size(), 0, errorMessage))
+    {
+        file_.close();
+        return false;
+    }
+    blocks_->reset();
+    block_ = blocks_->acquire();
+    blockFill_ = 0;
+    blockOffset_ = header_.recordsOffset;
+
+    openedNs_.store(nowNs, std::memory_order_relaxed);
+    stop_.store(false, std::memory_order_relaxed);
+    open_.store(true, std::memory_order_release);
+    thread_ = std::thread{ [this]() { run(); } };
+    return true;
+}
+
+bool captureWriter::close(std::string* errorMessage)
+{
+    if (!isOpen())
+    {
+        return true;
+    }
+    open_.store(false, std::memory_order_release);
+    stop_.store(true, std::memory_order_relaxed);
+    thread_.join();
+
+    // The partial last block; an empty one just goes back to the pool.
+    blocks_->submit(block_, blockFill_, blockOffset_);
+    blockOffset_ += blockFill_;
+    blockFill_ = 0;
+    block_ = {};
+    std::string error{};
+    bool succeeded{ blocks_->flush(&error) };
+
+    header_.slotCount = (blockOffset_ - header_.recordsOffset) / sizeof(packedInputEvent);
+    header_.eventCount = eventsWritten_.load(std::memory_order_relaxed);
+    header_.deviceTableOffset = blockOffset_;
+    header_.deviceCount = static_cast<std::uint32_t>(deviceCount_);
+    if (succeeded)
+    {
+        header_.flags |= captureFileHeader::completeFlag;
+        succeeded = file_.writeAt(devices_.data(), deviceCount_ * sizeof(captureDeviceEntry),
+                                  header_.deviceTableOffset, &error) &&
+                    file_.writeAt(&header_, sizeof(header_), 0, &error);
+    }
+    succeeded = file_.close(succeeded ? &error : nullptr) && succeeded;
+
+    if (!succeeded)
+    {
+        setError(errorMessage, error);
+    }
+    return succeeded;
+}
+
+void captureWriter::onInputEvent(const inputEvent& event)
+{
+    if (isOpen())
+    {
+        queue_.onInputEvent(event);
+    }
+}
+
+inputEvent* captureWriter::reserveEvent()
+{
+    return isOpen() ? queue_.reserveEvent() : nullptr;
+}
+
+void captureWriter::commitEvent()
+{
+    queue_.commitEvent();
+}
+
+captureWriterStats captureWriter::stats() const
+{
+    const auto blocks{ blocks_->stats() };
+    const auto queue{ queue_.counters() };
+    captureWriterStats result{};
+    result.eventsWritten = eventsWritten_.load(std::memory_order_relaxed);
+    result.bytesWritten = blocks.bytesWritten;
+    const auto openedNs{ openedNs_.load(std::memory_order_relaxed) };
+    const auto elapsedNs{ openedNs != 0 ? nowTimestampNs() - openedNs : 0 };
+    if (elapsedNs != 0)
+    {
+        result.bytesPerSecond = static_cast<double>(blocks.bytesWritten) * 1e9 / static_cast<double>(elapsedNs);
+    }
+    result.dropped = queue.dropped;
+    result.queuedEventsPeak = queue.highWaterMark;
+    result.blocksInFlight = blocks.inFlight;
+    result.blocksInFlightPeak = blocks.peakInFlight;
+    result.stalls = blocks.stalls;
+    result.backend = blocks_->backend();
+    result.failed = blocks.failed;
+    return result;
+}
+
+void captureWriter::run()
+{
+    while (!stop_.load(std::memory_order_relaxed))
+    {
+        drainQueue();
+        std::this_thread::sleep_for(options_.drainInterval);
+    }
+    drainQueue();
+}
+
+void captureWriter::drainQueue()
+{
+    queue_.drain(
+        [this](const inputEvent& event)
+        {
+            packedInputEvent slot{};
+            if (encoder_.tryPack(event, slot))
+            {
+                appendSlot(slot);
+            }
+            else
+            {
+                std::array<packedInputEvent, escapedSlotCount> parts{};
+                encoder_.packEscaped(event, parts);
+                for (const auto& part : parts)
+                {
+                    appendSlot(part);
+                }
+            }
+            recordDevice(event);
+            eventsWritten_.fetch_add(1, std::memory_order_relaxed);
+        });
+}
+
+void captureWriter::appendSlot(const packedInputEvent& slot)
+{
+    std::memcpy(block_.data() + blockFill_, &slot, sizeof(slot));
+    blockFill_ += sizeof(slot);
+    if (blockFill_ == block_.size())
+    {
+        submitBlock();
+    }
+}
+
+// Block writes stay page aligned in the file: the records start one page in and every full block is a whole number
+// of pages. Only the final, partial block on close ends elsewhere. After a failed write the blockWriter discards
+// further blocks, so the recording just stops growing.
+void captureWriter::submitBlock()
+{
+    blocks_->submit(block_, blockFill_, blockOffset_);
+    blockOffset_ += blockFill_;
+    blockFill_ = 0;
+    block_ = blocks_->acquire();
+}
+
+// A handful of devices is typical, so a linear scan of a fixed table beats anything clever. Devices beyond
+// maxDevices are still recorded, just not listed.
+void captureWriter::recordDevice(const inputEvent& event)
+{
+    const auto end{ devices_.begin() + static_cast<std::ptrdiff_t>(deviceCount_) };
+    auto entry{ std::find_if(devices_.begin(), end,
+                             [&event](const captureDeviceEntry& candidate)
+                             { return candidate.deviceId == event.deviceId && candidate.device == event.device; }) };
+    if (entry == end)
+    {
+        if (deviceCount_ == maxDevices)
+        {
+            return;
+        }
+        *entry = captureDeviceEntry{};
+        entry->deviceId = event.deviceId;
+        entry->device = event.device;
+        entry->firstTimestampNs = event.sourceTimestampNs;
+        ++deviceCount_;
+    }
+    ++entry->eventCount;
+    entry->firstTimestampNs = std::min(entry->firstTimestampNs, event.sourceTimestampNs);
+    entry->lastTimestampNs = std::max(entry->lastTimestampNs, event.sourceTimestampNs);
+}
+
+captureReader::~captureReader()
+{
+    close();
+}
+
+bool captureReader::open(const std::string& path, std::string* errorMessage)
+{
+    close();
+#ifdef _WIN32
+    fileHandle_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle_ == INVALID_HANDLE_VALUE)
+    {
+        fileHandle_ = nullptr;
+        setError(errorMessage, path + ": cannot open");
+        return false;
+    }
+    LARGE_INTEGER size{};
+    GetFileSizeEx(fileHandle_, &size);
+    mappingBytes_ = static_cast<std::size_t>(size.QuadPart);
+    if (mappingBytes_ >= sizeof(captureFileHeader))
+    {
+        mappingHandle_ = CreateFileMappingA(fileHandle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle_ != nullptr)
+        {
+            mapping_ = MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, 0);
+        }
+    }
+#else
+    const int descriptor{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+    if (descriptor < 0)
+    {
+        setError(errorMessage, path + ": " + std::strerror(errno));
+        return false;
+    }
+    struct stat status{};
+    if (fstat(descriptor, &status) == 0)
+    {
+        mappingBytes_ = static_cast<std::size_t>(status.st_size);
+    }
+    if (mappingBytes_ >= sizeof(captureFileHeader))
+    {
+        void* mapped{ mmap(nullptr, mappingBytes_, PROT_READ, MAP_SHARED, descriptor, 0) };
+        if (mapped != MAP_FAILED)
+        {
+            mapping_ = mapped;
+            // Readers walk the slots front to back.
+            madvise(mapped, mappingBytes_, MADV_SEQUENTIAL);
+        }
+    }
+    // The mapping keeps the file alive on its own.
+    ::close(descriptor);
+#endif
+    if (mapping_ == nullptr)
+    {
+        setError(errorMessage, path + ": not a capture file (too short or cannot be mapped)");
+        close();
+        return false;
+    }
+
+    const auto* bytes{ static_cast<const std::uint8_t*>(mapping_) };
+    std::memcpy(&header_, bytes, sizeof(header_));
+    if (header_.magic != captureFileHeader::expectedMagic || header_.version != captureFileHeader::currentVersion ||
+        header_.headerBytes < sizeof(captureFileHeader) || header_.recordsOffset > mappingBytes_ ||
+        header_.recordsOffset % alignof(packedInputEvent) != 0)
+    {
+        setError(errorMessage, path + ": not a capture file, or written by an unsupported version");
+        close();
+        return false;
+    }
+
+    const auto availableSlots{ (mappingBytes_ - header_.recordsOffset) / sizeof(packedInputEvent) };
+    std::size_t slotCount{ availableSlots };
+    if (isComplete())
+    {
+        const auto tableBytes{ std::uint64_t{ header_.deviceCount } * sizeof(captureDeviceEntry) };
+        if (header_.slotCount > availableSlots || header_.deviceTableOffset < header_.recordsOffset ||
+            header_.deviceTableOffset % alignof(captureDeviceEntry) != 0 ||
+            header_.deviceTableOffset > mappingBytes_ || tableBytes > mappingBytes_ - header_.deviceTableOffset)
+        {
+            setError(errorMessage, path + ": capture file is truncated");
+            close();
+            return false;
+        }
+        slotCount = static_cast<std::size_t>(header_.slotCount);
+        devices_ = { reinterpret_cast<const captureDeviceEntry*>(bytes + header_.deviceTableOffset),
+                     header_.deviceCount };
+    }
+    packedSlots_ = { reinterpret_cast<const packedInputEvent*>(bytes + header_.recordsOffset), slotCount };
+    return true;
+}
+
+void captureReader::close() noexcept
+{
+#ifdef _WIN32
+    if (mapping_ != nullptr)
+    {
+        UnmapViewOfFile(mapping_);
+    }
+    if (mappingHandle_ != nullptr)
+    {
+        CloseHandle(mappingHandle_);
+    }
+    if (fileHandle_ != nullptr)
+    {
+        CloseHandle(fileHandle_);
+    }
+    mappingHandle_ = nullptr;
+    fileHandle_ = nullptr;
+#else
+    if (mapping_ != nullptr)
+    {
+        munmap(const_cast<void*>(mapping_), mappingBytes_);
+    }
+#endif
+    mapping_ = nullptr;
+    mappingBytes_ = 0;
+    header_ = captureFileHeader{};
+    packedSlots_ = {};
+    devices_ = {};
+}
+
+} // namespace inputTester
@@ -0,0 +1,82 @@
+#include "inputtester/core/chatterDetector.h"
+
+#include <algorithm>
+
+namespace inputTester
+{
+
+chatterDetector::chatterDetector(std::uint64_t windowNs) noexcept : windowNs_{ windowNs }
+{
+    reset();
+}
+
+bool chatterDetector::record(std::uint32_t keyId, bool pressed, std::uint64_t timestampNs) noexcept
+{
+    if (keyId >= keyCount)
+    {
+        return false;
+    }
+    const auto wasDown{ down_[keyId] != 0 };
+    down_[keyId] = pressed ? 1 : 0;
+    if (!pressed)
+    {
+        if (wasDown)
+        {
+            lastReleaseNs_[keyId] = timestampNs;
+        }
+        return false;
+    }
+    if (wasDown)
+    {
+        return false;
+    }
+
+    ++presses_[keyId];
+    // The first press has no release before it.
+    if (presses_[keyId] == 1)
+    {
+        return false;
+    }
+    const auto gapNs{ timestampNs > lastReleaseNs_[keyId] ? timestampNs - lastReleaseNs_[keyId] : 0 };
+    minReleaseToPressNs_[keyId] = std::min(minReleaseToPressNs_[keyId], gapNs);
+    if (gapNs >= windowNs_)
+    {
+        return false;
+    }
+
+    if (bounces_[keyId]++ == 0)
+    {
+        ++chatteringKeys_;
+    }
+    lastBounceNs_[keyId] = timestampNs;
+    ++totalBounces_;
+    return true;
+}
+
+keyChatterStats chatterDetector::stats(std::uint32_t keyId) const noexcept
+{
+    if (keyId >= keyCount)
+    {
+        return {};
+    }
+    keyChatterStats result{};
+    result.presses = presses_[keyId];
+    result.bounces = bounces_[keyId];
+    result.minReleaseToPressNs = minReleaseToPressNs_[keyId];
+    result.lastBounceNs = lastBounceNs_[keyId];
+    return result;
+}
+
+void chatterDetector::reset() noexcept
+{
+    lastReleaseNs_.fill(0);
+    down_.fill(0);
+    presses_.fill(0);
+    bounces_.fill(0);
+    minReleaseToPressNs_.fill(keyChatterStats::noInterval);
+    lastBounceNs_.fill(0);
+    totalBounces_ = 0;
+    chatteringKeys_ = 0;
+}
+
+} // namespace inputTester
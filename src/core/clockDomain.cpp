@@ -0,0 +1,75 @@
+#include "inputtester/core/clockDomain.h"
+
+#include <cstddef>
+#include <limits>
+
+#include "inputtester/core/inputEvent.h"
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+namespace inputTester
+{
+
+namespace
+{
+
+constexpr std::size_t g_calibrationSamples{ 5 };
+
+#if defined(__linux__)
+std::uint64_t readPosixClockNs(clockid_t clockId)
+{
+    timespec now{};
+    clock_gettime(clockId, &now);
+    return static_cast<std::uint64_t>(now.tv_sec) * 1'000'000'000ULL + static_cast<std::uint64_t>(now.tv_nsec);
+}
+#endif
+
+} // namespace
+
+std::uint64_t readSourceClockNs(sourceClock clock)
+{
+    switch (clock)
+    {
+#if defined(__linux__)
+    case sourceClock::monotonic:
+        return readPosixClockNs(CLOCK_MONOTONIC);
+    case sourceClock::realtime:
+        return readPosixClockNs(CLOCK_REALTIME);
+#endif
+    default:
+        return nowTimestampNs();
+    }
+}
+
+clockDomainConverter::clockDomainConverter(sourceClock clock) : clock_{ clock }
+{
+    calibrate();
+}
+
+void clockDomainConverter::calibrate()
+{
+    if (clock_ == sourceClock::steady)
+    {
+        offsetNs_ = 0;
+        return;
+    }
+
+    // Bracket each source read between two steady reads and keep the tightest bracket.
+    std::uint64_t bestWindow{ std::numeric_limits<std::uint64_t>::max() };
+    for (std::size_t sample = 0; sample < g_calibrationSamples; ++sample)
+    {
+        const auto before{ nowTimestampNs() };
+        const auto source{ readSourceClockNs(clock_) };
+        const auto after{ nowTimestampNs() };
+        if (after - before < bestWindow)
+        {
+            bestWindow = after - before;
+            const auto midpoint{ before + (after - before) / 2 };
+            offsetNs_ = static_cast<std::int64_t>(midpoint) - static_cast<std::int64_t>(source);
+        }
+    }
+}
+
+} // namespace inputTester
@@ -0,0 +1,287 @@
+#include "inputtester/core/debounceSimulator.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace inputTester
+{
+
+namespace
+{
+
+constexpr std::uint64_t g_endOfInputNs{ std::numeric_limits<std::uint64_t>::max() };
+
+} // namespace
+
+debounceSimulator::debounceSimulator(std::span<const debounceModel> models) : rawDown_(keyCount, 0)
+{
+    models_.reserve(models.size());
+    for (const auto& model : models)
+    {
+        modelState state{};
+        state.model = model;
+        state.keys.resize(keyCount);
+        state.counters.resize(keyCount);
+        if (model.algorithm == debounceAlgorithm::globalDeferred)
+        {
+            state.divergent.reserve(keyCount);
+        }
+        models_.push_back(std::move(state));
+    }
+}
+
+void debounceSimulator::feed(std::span<const inputEvent> events)
+{
+    for (const auto& event : events)
+    {
+        if (event.device != deviceType::keyboard || event.isTextEvent ||
+            (event.kind != eventKind::keyDown && event.kind != eventKind::keyUp))
+        {
+            continue;
+        }
+        const auto keyId{ event.scanCode + (event.isExtended ? extendedKeyOffset : 0) };
+        const auto pressed{ event.kind == eventKind::keyDown };
+        if (keyId >= keyCount || (rawDown_[keyId] != 0) == pressed)
+        {
+            continue;
+        }
+        rawDown_[keyId] = pressed ? 1 : 0;
+        // Merged recordings can be slightly out of order across devices; time never runs backwards here.
+        lastEventNs_ = std::max(lastEventNs_, event.sourceTimestampNs);
+
+        for (auto& state : models_)
+        {
+            if (state.model.algorithm == debounceAlgorithm::globalDeferred)
+            {
+                settleGlobal(state, lastEventNs_);
+            }
+            else
+            {
+                settle(state, keyId, lastEventNs_);
+            }
+            applyEdge(state, keyId, pressed, lastEventNs_);
+        }
+    }
+}
+
+std::vector<debounceReport> debounceSimulator::finish()
+{
+    std::vector<debounceReport> reports{};
+    reports.reserve(models_.size());
+    for (auto& state : models_)
+    {
+        if (state.model.algorithm == debounceAlgorithm::globalDeferred)
+        {
+            settleGlobal(state, g_endOfInputNs);
+        }
+        else
+        {
+            for (std::uint32_t keyId = 0; keyId < keyCount; ++keyId)
+            {
+                settle(state, keyId, g_endOfInputNs);
+            }
+        }
+        reports.push_back(summarize(state));
+    }
+    return reports;
+}
+
+// Reports whatever the model would have reported on its own by nowNs, before the next edge arrives.
+void debounceSimulator::settle(modelState& state, std::uint32_t keyId, std::uint64_t nowNs)
+{
+    auto& key{ state.keys[keyId] };
+    if (key.raw == key.reported)
+    {
+        return;
+    }
+    const auto windowNs{ state.model.windowNs };
+    switch (state.model.algorithm)
+    {
+    case debounceAlgorithm::symmetricEager:
+        // The input changed during the lockout; the key reads it again once the lockout ends.
+        if (nowNs >= key.lockoutEndNs)
+        {
+            const auto atNs{ key.lockoutEndNs };
+            key.lockoutEndNs = atNs + windowNs;
+            report(state, keyId, atNs);
+        }
+        break;
+    case debounceAlgorithm::symmetricDeferred:
+    case debounceAlgorithm::asymmetricEagerDeferred:
+        if (nowNs - key.lastRawChangeNs >= windowNs)
+        {
+            report(state, keyId, key.lastRawChangeNs + windowNs);
+        }
+        break;
+    case debounceAlgorithm::globalDeferred:
+        break;
+    }
+}
+
+void debounceSimulator::settleGlobal(modelState& state, std::uint64_t nowNs)
+{
+    if (state.divergent.empty() || nowNs - state.lastAnyChangeNs < state.model.windowNs)
+    {
+        return;
+    }
+    const auto atNs{ state.lastAnyChangeNs + state.model.windowNs };
+    for (const auto keyId : state.divergent)
+    {
+        state.keys[keyId].queued = false;
+        if (state.keys[keyId].raw != state.keys[keyId].reported)
+        {
+            report(state, keyId, atNs);
+        }
+    }
+    state.divergent.clear();
+}
+
+void debounceSimulator::applyEdge(modelState& state, std::uint32_t keyId, bool pressed, std::uint64_t nowNs)
+{
+    auto& key{ state.keys[keyId] };
+    const auto windowNs{ state.model.windowNs };
+    ++state.counters[keyId].rawTransitions;
+    key.raw = pressed;
+    if (key.raw != key.reported)
+    {
+        // Edges closer together than the window belong to one burst; latency counts from its first edge.
+        if (!key.reverted || nowNs - key.revertedNs >= windowNs)
+        {
+            key.burstStartNs = nowNs;
+        }
+    }
+    else
+    {
+        key.reverted = true;
+        key.revertedNs = nowNs;
+    }
+    key.lastRawChangeNs = nowNs;
+
+    switch (state.model.algorithm)
+    {
+    case debounceAlgorithm::symmetricEager:
+        if (key.raw != key.reported && nowNs >= key.lockoutEndNs)
+        {
+            key.lockoutEndNs = nowNs + windowNs;
+            report(state, keyId, nowNs);
+        }
+        break;
+    case debounceAlgorithm::asymmetricEagerDeferred:
+        if (pressed && !key.reported)
+        {
+            report(state, keyId, nowNs);
+        }
+        break;
+    case debounceAlgorithm::globalDeferred:
+        state.lastAnyChangeNs = nowNs;
+        if (key.raw != key.reported && !key.queued)
+        {
+            key.queued = true;
+            state.divergent.push_back(keyId);
+        }
+        break;
+    case debounceAlgorithm::symmetricDeferred:
+        break;
+    }
+}
+
+void debounceSimulator::report(modelState& state, std::uint32_t keyId, std::uint64_t atNs)
+{
+    auto& key{ state.keys[keyId] };
+    auto& counters{ state.counters[keyId] };
+    key.reported = key.raw;
+    key.reverted = false;
+    const auto addedNs{ atNs - key.burstStartNs };
+    ++counters.reportedTransitions;
+    counters.totalAddedLatencyNs += addedNs;
+    counters.maxAddedLatencyNs = std::max(counters.maxAddedLatencyNs, addedNs);
+}
+
+debounceReport debounceSimulator::summarize(const modelState& state)
+{
+    debounceReport result{};
+    result.model = state.model;
+    std::uint64_t totalAddedLatencyNs{ 0 };
+    for (std::uint32_t keyId = 0; keyId < keyCount; ++keyId)
+    {
+        const auto& counters{ state.counters[keyId] };
+        if (counters.rawTransitions == 0)
+        {
+            continue;
+        }
+        debounceKeyReport key{};
+        key.keyId = keyId;
+        key.rawTransitions = counters.rawTransitions;
+        key.reportedTransitions = counters.reportedTransitions;
+        key.suppressedTransitions = counters.rawTransitions - counters.reportedTransitions;
+        key.totalAddedLatencyNs = counters.totalAddedLatencyNs;
+        key.maxAddedLatencyNs = counters.maxAddedLatencyNs;
+        result.keys.push_back(key);
+
+        result.rawTransitions += key.rawTransitions;
+        result.reportedTransitions += key.reportedTransitions;
+        result.maxAddedLatencyNs = std::max(result.maxAddedLatencyNs, key.maxAddedLatencyNs);
+        totalAddedLatencyNs += key.totalAddedLatencyNs;
+    }
+    result.suppressedTransitions = result.rawTransitions - result.reportedTransitions;
+    if (result.reportedTransitions != 0)
+    {
+        result.meanAddedLatencyNs =
+            static_cast<double>(totalAddedLatencyNs) / static_cast<double>(result.reportedTransitions);
+    }
+    return result;
+}
+
+std::vector<debounceReport> simulateDebounce(std::span<const inputEvent> events, std::span<const debounceModel> models,
+                                             debounceExecution execution)
+{
+    const auto hardwareThreads{ std::max(1U, std::thread::hardware_concurrency()) };
+    const auto workerCount{ execution == debounceExecution::parallel
+                                ? std::min<std::size_t>(models.size(), hardwareThreads)
+                                : std::size_t{ 1 } };
+    if (workerCount <= 1)
+    {
+        debounceSimulator simulator{ models };
+        simulator.feed(events);
+        return simulator.finish();
+    }
+
+    // Worker w owns models w, w + workerCount, ...; simulators are built here so workers never allocate state.
+    std::vector<std::vector<debounceModel>> groups(workerCount);
+    for (std::size_t index = 0; index < models.size(); ++index)
+    {
+        groups[index % workerCount].push_back(models[index]);
+    }
+    std::vector<debounceSimulator> simulators{};
+    simulators.reserve(workerCount);
+    for (const auto& group : groups)
+    {
+        simulators.emplace_back(group);
+    }
+    std::vector<std::vector<debounceReport>> groupReports(workerCount);
+    std::vector<std::thread> workers{};
+    workers.reserve(workerCount);
+    for (std::size_t worker = 0; worker < workerCount; ++worker)
+    {
+        workers.emplace_back(
+            [&, worker]()
+            {
+                simulators[worker].feed(events);
+                groupReports[worker] = simulators[worker].finish();
+            });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    std::vector<debounceReport> reports(models.size());
+    for (std::size_t index = 0; index < models.size(); ++index)
+    {
+        reports[index] = std::move(groupReports[index % workerCount][index / workerCount]);
+    }
+    return reports;
+}
+
+} // namespace inputTester
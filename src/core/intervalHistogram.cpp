@@ -0,0 +1,110 @@
+#include "inputtester/core/intervalHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace inputTester
+{
+
+namespace
+{
+
+constexpr double g_nanosecondsPerSecond{ 1'000'000'000.0 };
+
+// Rank (1-based) of the nearest-rank percentile among count values.
+std::uint64_t percentileRank(std::uint64_t count, double percent)
+{
+    const auto rank{ static_cast<std::uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(count))) };
+    return std::clamp<std::uint64_t>(rank, 1, count);
+}
+
+} // namespace
+
+void intervalHistogram::reset() noexcept
+{
+    counts_.fill(0);
+    count_ = 0;
+    minNs_ = 0;
+    maxNs_ = 0;
+    meanNs_ = 0.0;
+    squaredDeviationNs_ = 0.0;
+}
+
+std::uint64_t intervalHistogram::rankValueNs(std::uint64_t rank, std::size_t index) const noexcept
+{
+    // The extremes are known exactly; anything else reads as its bucket's midpoint.
+    if (rank <= 1)
+    {
+        return minNs_;
+    }
+    if (rank >= count_)
+    {
+        return maxNs_;
+    }
+    const auto low{ bucketLowNs(index) };
+    const auto high{ index + 1 < bucketCount ? bucketLowNs(index + 1) - 1 : maxNs_ };
+    return std::clamp(low + (high - low) / 2, minNs_, maxNs_);
+}
+
+std::uint64_t intervalHistogram::valueAtPercentile(double percent) const noexcept
+{
+    if (count_ == 0)
+    {
+        return 0;
+    }
+    const auto rank{ percentileRank(count_, percent) };
+    std::uint64_t seen{ 0 };
+    for (std::size_t index = 0; index < bucketCount; ++index)
+    {
+        seen += counts_[index];
+        if (seen >= rank)
+        {
+            return rankValueNs(rank, index);
+        }
+    }
+    return maxNs_;
+}
+
+intervalSummary intervalHistogram::summarize() const noexcept
+{
+    intervalSummary summary{};
+    summary.count = count_;
+    if (count_ == 0)
+    {
+        return summary;
+    }
+    summary.meanNs = meanNs_;
+    summary.rateHz = meanNs_ > 0.0 ? g_nanosecondsPerSecond / meanNs_ : 0.0;
+    summary.jitterNs = count_ > 1 ? std::sqrt(squaredDeviationNs_ / static_cast<double>(count_ - 1)) : 0.0;
+    summary.minNs = minNs_;
+    summary.maxNs = maxNs_;
+
+    // One pass for the three percentiles, a second for the outliers around the median.
+    const std::array<std::uint64_t, 3> ranks{ percentileRank(count_, 1.0), percentileRank(count_, 50.0),
+                                              percentileRank(count_, 99.0) };
+    std::array<std::uint64_t*, 3> values{ &summary.p1Ns, &summary.p50Ns, &summary.p99Ns };
+    std::size_t next{ 0 };
+    std::uint64_t seen{ 0 };
+    for (std::size_t index = 0; index < bucketCount && next < ranks.size(); ++index)
+    {
+        seen += counts_[index];
+        while (next < ranks.size() && seen >= ranks[next])
+        {
+            *values[next] = rankValueNs(ranks[next], index);
+            ++next;
+        }
+    }
+
+    const auto lowIndex{ bucketIndex(summary.p50Ns / 2) };
+    const auto highIndex{ bucketIndex(summary.p50Ns * 2) };
+    for (std::size_t index = 0; index < bucketCount; ++index)
+    {
+        if (index < lowIndex || index > highIndex)
+        {
+            summary.outliers += counts_[index];
+        }
+    }
+    return summary;
+}
+
+} // namespace inputTester
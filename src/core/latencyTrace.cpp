@@ -0,0 +1,121 @@
+#include "inputtester/core/latencyTrace.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace inputTester
+{
+
+namespace
+{
+
+constexpr std::size_t stageIndex(latencyStage stage)
+{
+    return static_cast<std::size_t>(stage);
+}
+
+// Nearest-rank on (count - 1), matching the age percentiles in spscBench.
+std::size_t percentileIndex(std::size_t count, std::size_t percent)
+{
+    return (count - 1) * percent / 100;
+}
+
+} // namespace
+
+latencyTrace::latencyTrace(std::size_t capacity)
+    : records_(std::bit_ceil(std::max<std::size_t>(capacity, 2))), scratch_(records_.size()),
+      mask_{ records_.size() - 1 }
+{
+}
+
+std::uint64_t latencyTrace::begin(const inputEvent& event, std::uint64_t enqueueNs, std::uint64_t dequeueNs) noexcept
+{
+    const auto sequence{ next_++ };
+    auto& record{ records_[sequence & mask_] };
+    record = stageStamps{};
+    record[stageIndex(latencyStage::source)] = event.sourceTimestampNs;
+    record[stageIndex(latencyStage::receive)] = event.receiveTimestampNs;
+    record[stageIndex(latencyStage::enqueue)] = enqueueNs;
+    record[stageIndex(latencyStage::dequeue)] = dequeueNs;
+    return sequence;
+}
+
+void latencyTrace::stamp(std::uint64_t sequence, latencyStage stage, std::uint64_t timestampNs) noexcept
+{
+    if (sequence < firstRetained() || sequence >= next_)
+    {
+        return;
+    }
+    records_[sequence & mask_][stageIndex(stage)] = timestampNs;
+}
+
+void latencyTrace::stampPainted(std::uint64_t timestampNs) noexcept
+{
+    for (auto sequence{ std::max(unpainted_, firstRetained()) }; sequence < next_; ++sequence)
+    {
+        records_[sequence & mask_][stageIndex(latencyStage::painted)] = timestampNs;
+    }
+    unpainted_ = next_;
+}
+
+void latencyTrace::reset() noexcept
+{
+    next_ = 0;
+    unpainted_ = 0;
+}
+
+latencySummary latencyTrace::summarize(latencyStage from, latencyStage to)
+{
+    std::size_t count{ 0 };
+    forEachRecord(
+        [this, &count, from, to](std::uint64_t, const stageStamps& stamps)
+        {
+            const auto fromNs{ stamps[stageIndex(from)] };
+            const auto toNs{ stamps[stageIndex(to)] };
+            // Stages that were never reached, or clocks that disagree, say nothing about this interval.
+            if (fromNs != 0 && toNs >= fromNs)
+            {
+                scratch_[count++] = toNs - fromNs;
+            }
+        });
+
+    latencySummary summary{};
+    summary.count = count;
+    if (count == 0)
+    {
+        return summary;
+    }
+    const auto first{ scratch_.begin() };
+    const auto last{ first + static_cast<std::ptrdiff_t>(count) };
+    const auto p50{ first + static_cast<std::ptrdiff_t>(percentileIndex(count, 50)) };
+    const auto p99{ first + static_cast<std::ptrdiff_t>(percentileIndex(count, 99)) };
+    std::nth_element(first, p50, last);
+    summary.p50Ns = *p50;
+    // Everything above p50 is now in (p50, last), so the higher ranks only need that tail.
+    std::nth_element(p50, p99, last);
+    summary.p99Ns = *p99;
+    summary.maxNs = *std::max_element(p99, last);
+    return summary;
+}
+
+const char* latencyTrace::stageName(latencyStage stage) noexcept
+{
+    switch (stage)
+    {
+    case latencyStage::source:
+        return "source";
+    case latencyStage::receive:
+        return "receive";
+    case latencyStage::enqueue:
+        return "enqueue";
+    case latencyStage::dequeue:
+        return "dequeue";
+    case latencyStage::handled:
+        return "handled";
+    case latencyStage::painted:
+        return "painted";
+    }
+    return "unknown";
+}
+
+} // namespace inputTester
@@ -0,0 +1,129 @@
+#include "inputtester/core/pollingRateDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace inputTester
+{
+
+namespace
+{
+
+constexpr double g_nanosecondsPerSecond{ 1'000'000'000.0 };
+// An interval fits a period when it is within this fraction of a period from a whole multiple. Tight enough
+// that 1 ms steps do not fit a 4 ms period, loose enough for evdev timestamp jitter at 8 kHz.
+constexpr double g_phaseTolerance{ 0.2 };
+// The slowest rate fitting at least this share of recent intervals wins.
+constexpr double g_fitThreshold{ 0.8 };
+// Running averages weight the last ~256 intervals.
+constexpr double g_minWeight{ 1.0 / 256.0 };
+// Below this many intervals no rate is reported; confidence ramps up to full over g_fullConfidenceIntervals.
+constexpr std::uint64_t g_minIntervals{ 16 };
+constexpr std::uint64_t g_fullConfidenceIntervals{ 64 };
+// Longer pauses are idle time; they carry no information about the period.
+constexpr std::uint64_t g_maxIntervalNs{ 100'000'000 };
+// A hole of up to this many periods inside a continuous stream counts as missed polls.
+constexpr std::uint64_t g_maxMissedPolls{ 4 };
+
+constexpr double periodNs(std::uint32_t rateHz)
+{
+    return g_nanosecondsPerSecond / static_cast<double>(rateHz);
+}
+
+// Whole periods in intervalNs, or 0 when it is not close to a multiple of the period.
+std::uint64_t wholePeriods(std::uint64_t intervalNs, double period)
+{
+    const auto periods{ static_cast<double>(intervalNs) / period };
+    const auto rounded{ std::round(periods) };
+    if (rounded < 1.0 || std::abs(periods - rounded) > g_phaseTolerance)
+    {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(rounded);
+}
+
+} // namespace
+
+void pollingRateDetector::record(std::uint64_t timestampNs) noexcept
+{
+    if (lastTimestampNs_ != 0 && timestampNs > lastTimestampNs_)
+    {
+        const auto intervalNs{ timestampNs - lastTimestampNs_ };
+        if (intervalNs <= g_maxIntervalNs)
+        {
+            recordInterval(intervalNs);
+        }
+        else
+        {
+            streaming_ = false;
+        }
+    }
+    lastTimestampNs_ = std::max(lastTimestampNs_, timestampNs);
+}
+
+void pollingRateDetector::recordInterval(std::uint64_t intervalNs) noexcept
+{
+    // Gaps are judged against the period established before this interval.
+    const auto current{ intervals_ >= g_minIntervals ? bestCandidate() : noCandidate };
+    if (current != noCandidate)
+    {
+        const auto periods{ wholePeriods(intervalNs, periodNs(candidateRatesHz[current])) };
+        if (periods >= 2 && periods <= g_maxMissedPolls && streaming_)
+        {
+            ++gaps_;
+            missedPolls_ += periods - 1;
+        }
+        streaming_ = periods == 1;
+    }
+
+    ++intervals_;
+    const auto weight{ std::max(g_minWeight, 1.0 / static_cast<double>(intervals_)) };
+    for (std::size_t candidate = 0; candidate < candidateRatesHz.size(); ++candidate)
+    {
+        const auto fits{ wholePeriods(intervalNs, periodNs(candidateRatesHz[candidate])) != 0 ? 1.0 : 0.0 };
+        fit_[candidate] += (fits - fit_[candidate]) * weight;
+    }
+}
+
+std::size_t pollingRateDetector::bestCandidate() const noexcept
+{
+    for (std::size_t candidate = 0; candidate < candidateRatesHz.size(); ++candidate)
+    {
+        if (fit_[candidate] >= g_fitThreshold)
+        {
+            return candidate;
+        }
+    }
+    return noCandidate;
+}
+
+pollingRateEstimate pollingRateDetector::estimate() const noexcept
+{
+    pollingRateEstimate result{};
+    result.intervals = intervals_;
+    result.gaps = gaps_;
+    result.missedPolls = missedPolls_;
+    const auto best{ intervals_ >= g_minIntervals ? bestCandidate() : noCandidate };
+    if (best == noCandidate)
+    {
+        return result;
+    }
+
+    result.rateHz = candidateRatesHz[best];
+    result.periodNs = static_cast<std::uint64_t>(periodNs(result.rateHz));
+    // Random whole-millisecond intervals still fit half the periods of the next slower rate, so anything
+    // at or below that counts as ruled out.
+    const auto slowerFit{ best > 0 ? fit_[best - 1] : 0.0 };
+    const auto ruledOut{ std::min(1.0, 2.0 * (1.0 - slowerFit)) };
+    const auto warmup{ std::min(1.0, static_cast<double>(intervals_) /
+                                         static_cast<double>(g_fullConfidenceIntervals)) };
+    result.confidence = fit_[best] * ruledOut * warmup;
+    return result;
+}
+
+void pollingRateDetector::reset() noexcept
+{
+    *this = pollingRateDetector{};
+}
+
+} // namespace inputTester
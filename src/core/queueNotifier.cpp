@@ -0,0 +1,56 @@
+#include "inputtester/core/queueNotifier.h"
+
+#include <cstdint>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace inputTester
+{
+
+#ifdef __linux__
+
+queueNotifier::queueNotifier() : handle_{ eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) }
+{
+}
+
+queueNotifier::~queueNotifier()
+{
+    if (handle_ >= 0)
+    {
+        close(handle_);
+    }
+}
+
+void queueNotifier::signal() const noexcept
+{
+    const std::uint64_t one{ 1 };
+    // EAGAIN only happens when the counter would overflow, i.e. a wakeup is already pending.
+    [[maybe_unused]] const auto written{ write(handle_, &one, sizeof(one)) };
+}
+
+void queueNotifier::acknowledge() const noexcept
+{
+    std::uint64_t count{};
+    [[maybe_unused]] const auto bytesRead{ read(handle_, &count, sizeof(count)) };
+}
+
+#else
+
+queueNotifier::queueNotifier() = default;
+
+queueNotifier::~queueNotifier() = default;
+
+void queueNotifier::signal() const noexcept
+{
+}
+
+void queueNotifier::acknowledge() const noexcept
+{
+}
+
+#endif
+
+} // namespace inputTester
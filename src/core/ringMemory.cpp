@@ -0,0 +1,137 @@
+#include "inputtester/core/ringMemory.h"
+
+#include <new>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace inputTester
+{
+
+namespace
+{
+
+constexpr std::size_t g_cacheLineSize{ 64 };
+
+#ifndef _WIN32
+constexpr std::size_t g_hugePageSize{ 2U * 1024U * 1024U };
+
+std::size_t roundUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+#endif
+
+} // namespace
+
+ringMemory::ringMemory(std::size_t bytes, ringMemoryOptions options) : size_{ bytes }
+{
+    if (bytes == 0)
+    {
+        return;
+    }
+
+    if (!options.lockPages && !options.hugePages)
+    {
+        data_ = ::operator new(bytes, std::align_val_t{ g_cacheLineSize });
+        return;
+    }
+
+    // Page-granular mappings are always cache-line aligned.
+#ifdef _WIN32
+    mappedSize_ = bytes;
+    data_ = VirtualAlloc(nullptr, mappedSize_, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (data_ == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+    if (options.lockPages)
+    {
+        locked_ = VirtualLock(data_, mappedSize_) != 0;
+    }
+#else
+    mappedSize_ = options.hugePages ? roundUp(bytes, g_hugePageSize) : bytes;
+    void* mapped{ mmap(nullptr, mappedSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+    if (mapped == MAP_FAILED)
+    {
+        throw std::bad_alloc{};
+    }
+    data_ = mapped;
+#ifdef MADV_HUGEPAGE
+    if (options.hugePages)
+    {
+        hugePagesAdvised_ = madvise(data_, mappedSize_, MADV_HUGEPAGE) == 0;
+    }
+#endif
+    if (options.lockPages)
+    {
+        locked_ = mlock(data_, mappedSize_) == 0;
+    }
+#endif
+}
+
+ringMemory::~ringMemory()
+{
+    release();
+}
+
+ringMemory::ringMemory(ringMemory&& other) noexcept
+    : data_{ std::exchange(other.data_, nullptr) }, size_{ std::exchange(other.size_, 0) },
+      mappedSize_{ std::exchange(other.mappedSize_, 0) }, locked_{ std::exchange(other.locked_, false) },
+      hugePagesAdvised_{ std::exchange(other.hugePagesAdvised_, false) }
+{
+}
+
+ringMemory& ringMemory::operator=(ringMemory&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mappedSize_ = std::exchange(other.mappedSize_, 0);
+        locked_ = std::exchange(other.locked_, false);
+        hugePagesAdvised_ = std::exchange(other.hugePagesAdvised_, false);
+    }
+    return *this;
+}
+
+void ringMemory::release() noexcept
+{
+    if (data_ == nullptr)
+    {
+        return;
+    }
+    if (mappedSize_ == 0)
+    {
+        ::operator delete(data_, std::align_val_t{ g_cacheLineSize });
+    }
+    else
+    {
+#ifdef _WIN32
+        if (locked_)
+        {
+            VirtualUnlock(data_, mappedSize_);
+        }
+        VirtualFree(data_, 0, MEM_RELEASE);
+#else
+        if (locked_)
+        {
+            munlock(data_, mappedSize_);
+        }
+        munmap(data_, mappedSize_);
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mappedSize_ = 0;
+    locked_ = false;
+    hugePagesAdvised_ = false;
+}
+
+} // namespace inputTester
@@ -0,0 +1,65 @@
+#include "inputtester/core/textRing.h"
+
+#include <algorithm>
+
+namespace inputTester
+{
+
+textRing::textRing(std::size_t capacity) : codePoints_(std::max<std::size_t>(capacity, 1))
+{
+}
+
+void textRing::push(char32_t codePoint) noexcept
+{
+    if (size_ == codePoints_.size())
+    {
+        // The oldest code point is only on screen if it was shown before.
+        if (shown_ != 0)
+        {
+            pendingFrontUnits_ += utf16Units(codePoints_[head_]);
+            --shown_;
+        }
+        head_ = (head_ + 1) % codePoints_.size();
+        --size_;
+    }
+    codePoints_[(head_ + size_) % codePoints_.size()] = codePoint;
+    ++size_;
+}
+
+bool textRing::backspace() noexcept
+{
+    if (size_ == 0)
+    {
+        return false;
+    }
+    --size_;
+    // Unshown text just disappears; shown text has to be cut from the end of the view.
+    if (size_ < shown_)
+    {
+        pendingBackUnits_ += utf16Units(at(size_));
+        shown_ = size_;
+    }
+    return true;
+}
+
+void textRing::clear() noexcept
+{
+    for (std::size_t index = 0; index < shown_; ++index)
+    {
+        pendingBackUnits_ += utf16Units(at(index));
+    }
+    head_ = 0;
+    size_ = 0;
+    shown_ = 0;
+}
+
+textRingDelta textRing::takeDelta() noexcept
+{
+    const textRingDelta delta{ pendingFrontUnits_, pendingBackUnits_, shown_ };
+    pendingFrontUnits_ = 0;
+    pendingBackUnits_ = 0;
+    shown_ = size_;
+    return delta;
+}
+
+} // namespace inputTester
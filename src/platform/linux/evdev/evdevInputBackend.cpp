@@ -0,0 +1,460 @@
+#include "evdevInputBackend.h"
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <QDebug>
+#include <QDir>
+
+namespace inputTester
+{
+
+namespace
+{
+
+constexpr std::uint64_t g_wakeToken{ ~std::uint64_t{ 0 } };
+constexpr std::size_t g_maxReadyEvents{ 16 };
+
+std::uint64_t recordTimestampNs(const input_event& record)
+{
+    return static_cast<std::uint64_t>(record.input_event_sec) * 1'000'000'000ULL +
+           static_cast<std::uint64_t>(record.input_event_usec) * 1'000ULL;
+}
+
+constexpr std::size_t g_bitsPerWord{ sizeof(unsigned long) * 8 };
+
+// Words in an evdev bitmask that holds bits 0..maxBit.
+constexpr std::size_t bitWords(unsigned int maxBit)
+{
+    return (maxBit + g_bitsPerWord) / g_bitsPerWord;
+}
+
+bool testBit(const unsigned long* bits, unsigned int bit)
+{
+    return (bits[bit / g_bitsPerWord] >> (bit % g_bitsPerWord)) & 1UL;
+}
+
+void setBit(unsigned long* bits, unsigned int bit, bool value)
+{
+    const auto mask{ 1UL << (bit % g_bitsPerWord) };
+    bits[bit / g_bitsPerWord] = value ? bits[bit / g_bitsPerWord] | mask : bits[bit / g_bitsPerWord] & ~mask;
+}
+
+// Keyboards and mice only. Switches report neither keys nor relative motion; joysticks and gamepads are told
+// apart by their buttons, touchscreens and tablets by INPUT_PROP_DIRECT.
+bool reportsKeysOrMotion(int fd)
+{
+    unsigned long eventBits[bitWords(EV_MAX)]{};
+    if (::ioctl(fd, EVIOCGBIT(0, sizeof(eventBits)), eventBits) < 0)
+    {
+        return false;
+    }
+    if (!testBit(eventBits, EV_KEY) && !testBit(eventBits, EV_REL))
+    {
+        return false;
+    }
+    unsigned long propertyBits[bitWords(INPUT_PROP_MAX)]{};
+    if (::ioctl(fd, EVIOCGPROP(sizeof(propertyBits)), propertyBits) >= 0 && testBit(propertyBits, INPUT_PROP_DIRECT))
+    {
+        return false;
+    }
+    unsigned long keyBits[bitWords(KEY_MAX)]{};
+    if (testBit(eventBits, EV_KEY) && ::ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) >= 0 &&
+        (testBit(keyBits, BTN_JOYSTICK) || testBit(keyBits, BTN_GAMEPAD)))
+    {
+        return false;
+    }
+    return true;
+}
+
+bool isMouseButton(std::uint16_t code)
+{
+    return code >= BTN_MOUSE && code < BTN_JOYSTICK;
+}
+
+bool isKeyboardKey(std::uint16_t code)
+{
+    return code < BTN_MISC || (code >= KEY_OK && code < BTN_DPAD_UP);
+}
+
+// Windows virtual keys for the buttons the rest of the app knows about.
+std::uint32_t mouseButtonVirtualKey(std::uint16_t code)
+{
+    switch (code)
+    {
+    case BTN_LEFT:
+        return 0x01;
+    case BTN_RIGHT:
+        return 0x02;
+    case BTN_MIDDLE:
+        return 0x04;
+    case BTN_SIDE:
+        return 0x05;
+    case BTN_EXTRA:
+        return 0x06;
+    default:
+        return 0;
+    }
+}
+
+} // namespace
+
+EvdevInputBackend::~EvdevInputBackend()
+{
+    stop();
+    for (const auto& source : m_sources)
+    {
+        if (source.fd >= 0)
+        {
+            ::close(source.fd);
+        }
+    }
+}
+
+void EvdevInputBackend::addSource(int fd, sourceClock clock)
+{
+    const auto flags{ ::fcntl(fd, F_GETFL) };
+    if (flags >= 0)
+    {
+        ::fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+    Source source{};
+    source.fd = fd;
+    source.deviceId = static_cast<std::uint32_t>(m_sources.size() + 1);
+    source.clock = clockDomainConverter{ clock };
+    m_sources.push_back(source);
+}
+
+void EvdevInputBackend::setKeyMap(LinuxKeymapParser::LinuxKeyMap keyMap)
+{
+    m_keyMap = std::move(keyMap);
+    m_hasKeyMap = true;
+}
+
+bool EvdevInputBackend::start(QObject* /*eventSource*/, QString* errorMessage)
+{
+    stop();
+    if (!m_hasKeyMap)
+    {
+        if (!LinuxKeymapParser::loadConfiguredLinuxKeyMap(&m_keyMap, errorMessage))
+        {
+            return false;
+        }
+        m_hasKeyMap = true;
+    }
+    if (m_sources.empty() && !openDevices(errorMessage))
+    {
+        return false;
+    }
+
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFd < 0 || m_wakeFd < 0)
+    {
+        if (errorMessage != nullptr)
+        {
+            *errorMessage = QString("evdev backend: epoll setup failed (%1)").arg(std::strerror(errno));
+        }
+        stop();
+        return false;
+    }
+
+    epoll_event wake{};
+    wake.events = EPOLLIN;
+    wake.data.u64 = g_wakeToken;
+    bool watching{ ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &wake) == 0 };
+    for (std::size_t index = 0; watching && index < m_sources.size(); ++index)
+    {
+        if (!m_sources[index].isOpen)
+        {
+            continue;
+        }
+        epoll_event readable{};
+        readable.events = EPOLLIN;
+        readable.data.u64 = index;
+        watching = ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_sources[index].fd, &readable) == 0;
+    }
+    if (!watching)
+    {
+        if (errorMessage != nullptr)
+        {
+            *errorMessage = QString("evdev backend: epoll registration failed (%1)").arg(std::strerror(errno));
+        }
+        stop();
+        return false;
+    }
+
+    m_thread = std::thread{ [this]() { run(); } };
+    return true;
+}
+
+void EvdevInputBackend::stop()
+{
+    if (m_thread.joinable())
+    {
+        const std::uint64_t one{ 1 };
+        [[maybe_unused]] const auto written{ ::write(m_wakeFd, &one, sizeof(one)) };
+        m_thread.join();
+    }
+    if (m_epollFd >= 0)
+    {
+        ::close(m_epollFd);
+        m_epollFd = -1;
+    }
+    if (m_wakeFd >= 0)
+    {
+        ::close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+}
+
+void EvdevInputBackend::setSink(inputEventSink* sink)
+{
+    m_sink = sink;
+}
+
+std::uint64_t EvdevInputBackend::overrunCount() const
+{
+    return m_overruns.load(std::memory_order_relaxed);
+}
+
+bool EvdevInputBackend::openDevices(QString* errorMessage)
+{
+    const QDir inputDir{ "/dev/input" };
+    const auto names{ inputDir.entryList({ "event*" }, QDir::System, QDir::Name) };
+    for (const auto& name : names)
+    {
+        const auto path{ inputDir.filePath(name).toLocal8Bit() };
+        const int fd{ ::open(path.constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC) };
+        if (fd < 0)
+        {
+            continue;
+        }
+        if (!reportsKeysOrMotion(fd))
+        {
+            ::close(fd);
+            continue;
+        }
+        // Ask for monotonic stamps; older kernels keep stamping wall-clock time.
+        int clockId{ CLOCK_MONOTONIC };
+        const bool isMonotonic{ ::ioctl(fd, EVIOCSCLOCKID, &clockId) == 0 };
+        addSource(fd, isMonotonic ? sourceClock::monotonic : sourceClock::realtime);
+    }
+
+    if (m_sources.empty())
+    {
+        if (errorMessage != nullptr)
+        {
+            *errorMessage = "evdev backend: no readable keyboard or mouse under /dev/input (is the user in the "
+                            "'input' group?)";
+        }
+        return false;
+    }
+    return true;
+}
+
+void EvdevInputBackend::run()
+{
+    std::array<epoll_event, g_maxReadyEvents> ready{};
+    for (;;)
+    {
+        const int count{ ::epoll_wait(m_epollFd, ready.data(), static_cast<int>(ready.size()), -1) };
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        for (int index = 0; index < count; ++index)
+        {
+            if (ready[index].data.u64 == g_wakeToken)
+            {
+                return;
+            }
+            readSource(m_sources[static_cast<std::size_t>(ready[index].data.u64)]);
+        }
+    }
+}
+
+void EvdevInputBackend::readSource(Source& source)
+{
+    for (;;)
+    {
+        const auto bytesRead{ ::read(source.fd, source.buffer.data() + source.pendingBytes,
+                                     source.buffer.size() - source.pendingBytes) };
+        if (bytesRead <= 0)
+        {
+            if (bytesRead < 0 && (errno == EAGAIN || errno == EINTR))
+            {
+                return;
+            }
+            // End of stream, or the device was unplugged (ENODEV).
+            if (::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, source.fd, nullptr) < 0)
+            {
+                // Still registered: closing it is the only way to stop it waking the loop forever.
+                qWarning().noquote() << "evdev backend: could not stop watching device" << source.deviceId << "("
+                                     << std::strerror(errno) << "), closing it";
+                ::close(source.fd);
+                source.fd = -1;
+            }
+            source.isOpen = false;
+            return;
+        }
+
+        const auto receiveNs{ nowTimestampNs() };
+        const auto available{ source.pendingBytes + static_cast<std::size_t>(bytesRead) };
+        const auto records{ available / sizeof(input_event) };
+        for (std::size_t index = 0; index < records; ++index)
+        {
+            input_event record{};
+            std::memcpy(&record, source.buffer.data() + index * sizeof(input_event), sizeof(record));
+            handleRecord(source, record, receiveNs);
+        }
+        source.pendingBytes = available - records * sizeof(input_event);
+        std::memmove(source.buffer.data(), source.buffer.data() + records * sizeof(input_event),
+                     source.pendingBytes);
+    }
+}
+
+void EvdevInputBackend::handleRecord(Source& source, const input_event& record, std::uint64_t receiveNs)
+{
+    if (source.isResyncing)
+    {
+        if (record.type == EV_SYN && record.code == SYN_REPORT)
+        {
+            source.isResyncing = false;
+            resyncKeys(source, record, receiveNs);
+        }
+        return;
+    }
+    switch (record.type)
+    {
+    case EV_KEY:
+        emitKey(source, record, receiveNs);
+        break;
+    case EV_REL:
+        if (record.code == REL_X || record.code == REL_Y)
+        {
+            source.hasMotion = true;
+        }
+        break;
+    case EV_SYN:
+        // The kernel's buffer overflowed: the rest of this frame and everything up to the next report is gone,
+        // including the motion collected so far, which would otherwise stand in for the lost samples.
+        if (record.code == SYN_DROPPED)
+        {
+            source.isResyncing = true;
+            source.hasMotion = false;
+            m_overruns.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        // One motion event per report frame, however many axes moved.
+        if (record.code == SYN_REPORT && source.hasMotion)
+        {
+            source.hasMotion = false;
+            emitMotion(source, record, receiveNs);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void EvdevInputBackend::emitKey(Source& source, const input_event& record, std::uint64_t receiveNs)
+{
+    const bool mouseButton{ isMouseButton(record.code) };
+    if (!mouseButton && !isKeyboardKey(record.code))
+    {
+        return;
+    }
+    setBit(source.heldKeys.data(), record.code, record.value != 0);
+    if (m_sink == nullptr)
+    {
+        return;
+    }
+    inputEvent fallback{};
+    auto* slot{ reserveEvent(*m_sink, fallback) };
+    if (slot == nullptr)
+    {
+        return;
+    }
+    slot->sourceTimestampNs = source.clock.toSteadyNs(recordTimestampNs(record));
+    slot->receiveTimestampNs = receiveNs;
+    slot->deviceId = source.deviceId;
+    // value: 0 release, 1 press, 2 autorepeat.
+    slot->kind = record.value == 0 ? eventKind::keyUp : eventKind::keyDown;
+    slot->repeatCount = static_cast<std::uint16_t>(record.value == 2 ? 1 : 0);
+    if (mouseButton)
+    {
+        slot->device = deviceType::mouse;
+        slot->virtualKey = mouseButtonVirtualKey(record.code);
+        slot->scanCode = record.code;
+    }
+    else
+    {
+        const auto translated{ LinuxKeymapParser::translateLinuxScanCode(m_keyMap, record.code) };
+        slot->device = deviceType::keyboard;
+        slot->scanCode = translated.scanCode;
+        slot->isExtended = translated.isExtended;
+    }
+    commitEvent(*m_sink, fallback);
+}
+
+// Releases the keys this source reported down that the device no longer holds, stamped with the report that
+// ended the overrun. Presses lost in the overrun are not invented; their releases arrive as usual. A source
+// that cannot be queried (a pipe) releases everything it held.
+void EvdevInputBackend::resyncKeys(Source& source, const input_event& report, std::uint64_t receiveNs)
+{
+    std::array<unsigned long, g_keyBitWords> deviceKeys{};
+    if (::ioctl(source.fd, EVIOCGKEY(sizeof(deviceKeys)), deviceKeys.data()) < 0)
+    {
+        deviceKeys.fill(0);
+    }
+    input_event release{ report };
+    release.type = EV_KEY;
+    release.value = 0;
+    for (std::size_t word = 0; word < deviceKeys.size(); ++word)
+    {
+        const auto released{ source.heldKeys[word] & ~deviceKeys[word] };
+        for (unsigned int bit = 0; bit < g_bitsPerWord; ++bit)
+        {
+            if ((released >> bit) & 1UL)
+            {
+                release.code = static_cast<std::uint16_t>(word * g_bitsPerWord + bit);
+                emitKey(source, release, receiveNs);
+            }
+        }
+    }
+}
+
+void EvdevInputBackend::emitMotion(const Source& source, const input_event& record, std::uint64_t receiveNs)
+{
+    inputEvent fallback{};
+    auto* slot{ m_sink != nullptr ? reserveEvent(*m_sink, fallback) : nullptr };
+    if (slot == nullptr)
+    {
+        return;
+    }
+    slot->sourceTimestampNs = source.clock.toSteadyNs(recordTimestampNs(record));
+    slot->receiveTimestampNs = receiveNs;
+    slot->deviceId = source.deviceId;
+    slot->device = deviceType::mouse;
+    slot->kind = eventKind::motion;
+    commitEvent(*m_sink, fallback);
+}
+
+std::unique_ptr<inputBackend> createEvdevInputBackend()
+{
+    return std::make_unique<EvdevInputBackend>();
+}
+
+} // namespace inputTester
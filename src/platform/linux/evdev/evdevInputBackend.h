@@ -0,0 +1,93 @@
+#ifndef inputTesterPlatformEvdevInputBackendH
+#define inputTesterPlatformEvdevInputBackendH
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <linux/input.h>
+
+#include <QString>
+
+#include "inputtester/core/clockDomain.h"
+#include "inputtester/core/inputEvent.h"
+#include "inputtester/platform/inputBackend.h"
+#include "linuxKeymapParser.h"
+
+namespace inputTester
+{
+
+// Reads struct input_event records straight from evdev nodes on its own epoll thread, so events carry the
+// kernel timestamp and keep arriving while the window is unfocused or the GUI thread is busy. Key events
+// have scan codes but no virtual key or text.
+class EvdevInputBackend final : public inputBackend
+{
+public:
+    EvdevInputBackend() = default;
+    ~EvdevInputBackend() override;
+
+    EvdevInputBackend(const EvdevInputBackend&) = delete;
+    EvdevInputBackend& operator=(const EvdevInputBackend&) = delete;
+
+    // Adds any readable fd that carries input_event records (an evdev node, or a pipe fed with recorded
+    // events) stamped with clock; the backend takes ownership. Call before start(). Without sources, start()
+    // opens every /dev/input/event* keyboard and mouse.
+    void addSource(int fd, sourceClock clock = sourceClock::monotonic);
+
+    // Replaces the bundled keymap; call before start().
+    void setKeyMap(LinuxKeymapParser::LinuxKeyMap keyMap);
+
+    // eventSource is unused: events come from the devices, not from Qt.
+    bool start(QObject* eventSource, QString* errorMessage) override;
+    void stop() override;
+
+    // Events are delivered on the reader thread; call before start().
+    void setSink(inputEventSink* sink) override;
+
+    // SYN_DROPPED frames seen on any device since construction.
+    std::uint64_t overrunCount() const override;
+
+private:
+    static constexpr std::size_t g_readBatch{ 64 };
+    static constexpr std::size_t g_keyBitWords{ (KEY_MAX + sizeof(unsigned long) * 8) / (sizeof(unsigned long) * 8) };
+
+    struct Source
+    {
+        int fd{ -1 };
+        std::uint32_t deviceId{};
+        clockDomainConverter clock{};
+        bool isOpen{ true };
+        // Pipes may split a record across reads; the tail waits here for the rest.
+        std::array<unsigned char, g_readBatch * sizeof(input_event)> buffer{};
+        std::size_t pendingBytes{};
+        bool hasMotion{ false };
+        // After SYN_DROPPED, records up to the next SYN_REPORT belong to a partly lost frame and are skipped.
+        bool isResyncing{ false };
+        // Keys and buttons this source has reported as down, as an EVIOCGKEY bitmask.
+        std::array<unsigned long, g_keyBitWords> heldKeys{};
+    };
+
+    bool openDevices(QString* errorMessage);
+    void run();
+    void readSource(Source& source);
+    void handleRecord(Source& source, const input_event& record, std::uint64_t receiveNs);
+    void emitKey(Source& source, const input_event& record, std::uint64_t receiveNs);
+    void resyncKeys(Source& source, const input_event& report, std::uint64_t receiveNs);
+    void emitMotion(const Source& source, const input_event& record, std::uint64_t receiveNs);
+
+    std::vector<Source> m_sources;
+    LinuxKeymapParser::LinuxKeyMap m_keyMap{};
+    bool m_hasKeyMap{ false };
+    inputEventSink* m_sink{};
+    int m_epollFd{ -1 };
+    int m_wakeFd{ -1 };
+    std::thread m_thread;
+    std::atomic<std::uint64_t> m_overruns{};
+};
+
+} // namespace inputTester
+
+#endif // inputTesterPlatformEvdevInputBackendH
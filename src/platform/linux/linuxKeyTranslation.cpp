@@ -0,0 +1,75 @@
+#include "linuxKeyTranslation.h"
+
+namespace inputTester
+{
+
+namespace
+{
+
+LinuxKeymapParser::ScanTranslation translateScanCode(const LinuxKeymapParser::LinuxKeyMap& map, const QKeyEvent* event)
+{
+    std::uint32_t nativeScan{ static_cast<std::uint32_t>(event->nativeScanCode()) };
+    const auto offset{ map.nativeScanCodeOffset };
+    if (offset != 0 && nativeScan >= offset)
+    {
+        nativeScan -= offset;
+    }
+
+    return LinuxKeymapParser::translateLinuxScanCode(map, nativeScan);
+}
+
+} // namespace
+
+char32_t firstCodepoint(const QString& text) noexcept
+{
+    if (text.isEmpty())
+    {
+        return U'\0';
+    }
+    const auto first{ text.at(0) };
+    if (!first.isSurrogate())
+    {
+        return static_cast<char32_t>(first.unicode());
+    }
+    if (first.isHighSurrogate() && text.size() > 1 && text.at(1).isLowSurrogate())
+    {
+        return static_cast<char32_t>(QChar::surrogateToUcs4(first, text.at(1)));
+    }
+    return U'\uFFFD';
+}
+
+void translateKeyEvent(const LinuxKeymapParser::LinuxKeyMap& map, const QKeyEvent* event, eventKind kind,
+                       inputEvent& keyEvent)
+{
+    // Qt's event time (the X server / compositor time) only has millisecond resolution, coarser than the
+    // nanosecond receive time, so the receive time stands in for the source time.
+    keyEvent.receiveTimestampNs = nowTimestampNs();
+    keyEvent.sourceTimestampNs = keyEvent.receiveTimestampNs;
+    keyEvent.device = deviceType::keyboard;
+    keyEvent.kind = kind;
+    keyEvent.virtualKey = LinuxKeymapParser::lookupVirtualKey(map, event->key(),
+                                                              (event->modifiers() & Qt::KeypadModifier) != 0);
+    const auto translated{ translateScanCode(map, event) };
+    keyEvent.scanCode = translated.scanCode;
+    keyEvent.repeatCount = static_cast<std::uint16_t>(event->isAutoRepeat() ? 1 : 0);
+    keyEvent.isExtended = translated.isExtended;
+
+    if (kind == eventKind::keyDown)
+    {
+        if (event->key() == Qt::Key_Backspace)
+        {
+            keyEvent.text = U'\b';
+        }
+        else if (event->key() == Qt::Key_Return || event->key() == Qt::Key_Enter)
+        {
+            keyEvent.text = U'\n';
+        }
+        else
+        {
+            // text() hands back the event's implicitly shared string, so this copies no characters.
+            keyEvent.text = firstCodepoint(event->text());
+        }
+    }
+}
+
+} // namespace inputTester
@@ -0,0 +1,22 @@
+#ifndef inputTesterPlatformLinuxKeyTranslationH
+#define inputTesterPlatformLinuxKeyTranslationH
+
+#include <QKeyEvent>
+#include <QString>
+
+#include "inputtester/core/inputEvent.h"
+#include "linuxKeymapParser.h"
+
+namespace inputTester
+{
+
+// First code point of UTF-16 text, decoded in place; a lone surrogate yields U+FFFD.
+char32_t firstCodepoint(const QString& text) noexcept;
+
+// Fills keyEvent from a Qt key event. Runs for every key press on the GUI thread and does not allocate.
+void translateKeyEvent(const LinuxKeymapParser::LinuxKeyMap& map, const QKeyEvent* event, eventKind kind,
+                       inputEvent& keyEvent);
+
+} // namespace inputTester
+
+#endif // inputTesterPlatformLinuxKeyTranslationH
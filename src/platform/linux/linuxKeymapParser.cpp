@@ -1,11 +1,16 @@
 #include "linuxKeymapParser.h"
 
 #include <cmath>
+#include <stdexcept>
 
+#include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QMetaEnum>
+#include <QtGlobal>
+
+#include "linuxKeymapTables.h"
 
 namespace LinuxKeymapParser
 {
@@ -13,6 +18,30 @@ namespace LinuxKeymapParser
 namespace
 {
 
+constexpr LinuxKeyMap buildBundledKeyMap()
+{
+    LinuxKeyMap map{};
+    map.nativeScanCodeOffset = generated::g_nativeScanCodeOffset;
+    for (const auto& mapping : generated::g_qtKeyMappings)
+    {
+        if (!setQtKeyMapping(map, mapping))
+        {
+            throw std::invalid_argument("linux_keymap.json: qtKey outside the table range or virtualKey not 1-255");
+        }
+    }
+    for (const auto& mapping : generated::g_scanMappings)
+    {
+        if (!setScanMapping(map, mapping))
+        {
+            throw std::invalid_argument("linux_keymap.json: linuxScanCode outside the table range");
+        }
+    }
+    return map;
+}
+
+// Built by the compiler, so startup neither reads nor parses the JSON.
+constexpr LinuxKeyMap g_bundledKeyMap{ buildBundledKeyMap() };
+
 QString valueTypeName(const QJsonValue& value)
 {
     if (value.isString())
@@ -128,7 +157,7 @@ bool parseNativeScanCodeOffset(const QJsonObject& root, LinuxKeyMap& result, std
     return true;
 }
 
-bool parseQtKeyMapping(const QJsonObject& root, LinuxKeyMap& result, std::vector<QString>* errors)
+bool parseQtKeyMapping(const QJsonObject& root, LinuxKeyMap& result, std::size_t* count, std::vector<QString>* errors)
 {
     const auto qtKeyArrayValue{ root.value("qtKeyToVirtualKey") };
     if (!qtKeyArrayValue.isArray())
@@ -145,6 +174,7 @@ bool parseQtKeyMapping(const QJsonObject& root, LinuxKeyMap& result, std::vector
 
     bool ok{ true };
     const auto keyEnum{ QMetaEnum::fromType<Qt::Key>() };
+    std::vector<bool> seen(g_qtKeyIndexCount, false);
 
     for (int index{ 0 }; index < qtKeyArray.size(); ++index)
     {
@@ -189,19 +219,27 @@ bool parseQtKeyMapping(const QJsonObject& root, LinuxKeyMap& result, std::vector
             }
         }
 
-        const auto mapKey{ makeQtKeyMapKey(qtKey, keypad) };
-        if (result.qtKeyToVirtualKey.find(mapKey) != result.qtKeyToVirtualKey.end())
+        const auto index{ qtKeyIndex(qtKey, keypad) };
+        if (index < seen.size() && seen[index])
         {
             appendError(errors, itemPath, "duplicate entry");
             ok = false;
             continue;
         }
-        result.qtKeyToVirtualKey.emplace(mapKey, virtualKey);
+        if (!setQtKeyMapping(result, QtKeyMapping{ qtKey, keypad, virtualKey }))
+        {
+            appendError(errors, itemPath, "qtKey outside the supported range or virtualKey not 1-255");
+            ok = false;
+            continue;
+        }
+        seen[index] = true;
+        ++*count;
     }
     return ok;
 }
 
-bool parseScanCodeMapping(const QJsonObject& root, LinuxKeyMap& result, std::vector<QString>* errors)
+bool parseScanCodeMapping(const QJsonObject& root, LinuxKeyMap& result, std::size_t* count,
+                          std::vector<QString>* errors)
 {
     const auto scanArrayValue{ root.value("linuxScanToWinScan") };
     if (!scanArrayValue.isArray())
@@ -217,6 +255,7 @@ bool parseScanCodeMapping(const QJsonObject& root, LinuxKeyMap& result, std::vec
     }
 
     bool ok{ true };
+    std::vector<bool> seen(g_linuxScanCodeCount, false);
     for (int index{ 0 }; index < scanArray.size(); ++index)
     {
         const auto item{ scanArray.at(index) };
@@ -260,24 +299,29 @@ bool parseScanCodeMapping(const QJsonObject& root, LinuxKeyMap& result, std::vec
             }
         }
 
-        if (result.linuxScanToWinScan.find(linuxScan) != result.linuxScanToWinScan.end())
+        if (linuxScan < seen.size() && seen[linuxScan])
         {
             appendError(errors, itemPath, "duplicate entry");
             ok = false;
             continue;
         }
-
-        result.linuxScanToWinScan.emplace(linuxScan, ScanTranslation{ winScan, isExtended });
+        if (!setScanMapping(result, ScanMapping{ linuxScan, winScan, isExtended }))
+        {
+            appendError(errors, itemPath + ".linuxScanCode", "outside the supported range");
+            ok = false;
+            continue;
+        }
+        seen[linuxScan] = true;
+        ++*count;
     }
     return ok;
 }
 
 } // namespace
 
-std::uint64_t makeQtKeyMapKey(int qtKey, bool keypad)
+const LinuxKeyMap& bundledLinuxKeyMap()
 {
-    const auto keyValue{ static_cast<std::uint64_t>(static_cast<std::uint32_t>(qtKey)) };
-    return (keyValue << 1) | (keypad ? 1U : 0U);
+    return g_bundledKeyMap;
 }
 
 QString formatErrors(const std::vector<QString>& errors)
@@ -294,6 +338,50 @@ QString formatErrors(const std::vector<QString>& errors)
     return message;
 }
 
+bool loadLinuxKeyMap(const QString& path, LinuxKeyMap* outMap, QString* errorMessage)
+{
+    QFile file{ path };
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        if (errorMessage != nullptr)
+        {
+            *errorMessage = QString("linux keymap: failed to open %1").arg(path);
+        }
+        return false;
+    }
+
+    LinuxKeyMap map{};
+    std::vector<QString> errors{};
+    if (!parseLinuxKeyMap(file.readAll(), &map, &errors))
+    {
+        if (errorMessage != nullptr)
+        {
+            *errorMessage = formatErrors(errors);
+        }
+        return false;
+    }
+
+    if (outMap != nullptr)
+    {
+        *outMap = std::move(map);
+    }
+    return true;
+}
+
+bool loadConfiguredLinuxKeyMap(LinuxKeyMap* outMap, QString* errorMessage)
+{
+    const auto overridePath{ qEnvironmentVariable(g_keyMapOverrideVariable) };
+    if (!overridePath.isEmpty())
+    {
+        return loadLinuxKeyMap(overridePath, outMap, errorMessage);
+    }
+    if (outMap != nullptr)
+    {
+        *outMap = g_bundledKeyMap;
+    }
+    return true;
+}
+
 bool parseLinuxKeyMap(const QByteArray& data, LinuxKeyMap* outMap, std::vector<QString>* errors)
 {
     if (errors != nullptr)
@@ -319,22 +407,24 @@ bool parseLinuxKeyMap(const QByteArray& data, LinuxKeyMap* outMap, std::vector<Q
         ok = false;
     }
 
-    if (!parseQtKeyMapping(root, result, errors))
+    std::size_t qtKeyCount{ 0 };
+    if (!parseQtKeyMapping(root, result, &qtKeyCount, errors))
     {
         ok = false;
     }
 
-    if (!parseScanCodeMapping(root, result, errors))
+    std::size_t scanCount{ 0 };
+    if (!parseScanCodeMapping(root, result, &scanCount, errors))
     {
         ok = false;
     }
 
-    if (result.qtKeyToVirtualKey.empty())
+    if (qtKeyCount == 0)
     {
         appendError(errors, "qtKeyToVirtualKey", "empty mapping");
         ok = false;
     }
-    if (result.linuxScanToWinScan.empty())
+    if (scanCount == 0)
     {
         appendError(errors, "linuxScanToWinScan", "empty mapping");
         ok = false;
@@ -1,8 +1,9 @@
 #ifndef inputTesterPlatformLinuxKeymapParserH
 #define inputTesterPlatformLinuxKeymapParserH
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <unordered_map>
 #include <vector>
 
 #include <QByteArray>
@@ -11,23 +12,132 @@
 namespace LinuxKeymapParser
 {
 
+// Set to the path of a keymap JSON file to replace the bundled map at startup.
+inline constexpr char g_keyMapOverrideVariable[]{ "INPUTTESTER_LINUX_KEYMAP" };
+
+// Qt::Key values are Latin-1 for printable keys and start at 0x01000000 for special keys; evdev key codes
+// end at KEY_MAX (0x2ff). Keys outside these ranges cannot be mapped.
+inline constexpr std::uint32_t g_qtLatin1KeyCount{ 0x100 };
+inline constexpr std::uint32_t g_qtSpecialKeyBase{ 0x01000000 };
+inline constexpr std::uint32_t g_qtSpecialKeyCount{ 0x200 };
+inline constexpr std::size_t g_qtKeyIndexCount{ 2 * (g_qtLatin1KeyCount + g_qtSpecialKeyCount) };
+inline constexpr std::size_t g_linuxScanCodeCount{ 0x300 };
+
 struct ScanTranslation
 {
     std::uint32_t scanCode{};
     bool isExtended{};
 };
 
+struct QtKeyMapping
+{
+    int qtKey{};
+    bool keypad{};
+    std::uint32_t virtualKey{};
+};
+
+struct ScanMapping
+{
+    std::uint32_t linuxScanCode{};
+    std::uint32_t winScanCode{};
+    bool isExtended{};
+};
+
+// Returns g_qtKeyIndexCount for keys outside the table ranges.
+constexpr std::size_t qtKeyIndex(int qtKey, bool keypad) noexcept
+{
+    const auto key{ static_cast<std::uint32_t>(qtKey) };
+    std::size_t index{};
+    if (key < g_qtLatin1KeyCount)
+    {
+        index = key;
+    }
+    else if (key >= g_qtSpecialKeyBase && key - g_qtSpecialKeyBase < g_qtSpecialKeyCount)
+    {
+        index = g_qtLatin1KeyCount + (key - g_qtSpecialKeyBase);
+    }
+    else
+    {
+        return g_qtKeyIndexCount;
+    }
+    return index * 2 + (keypad ? 1 : 0);
+}
+
+constexpr std::array<ScanTranslation, g_linuxScanCodeCount> makeIdentityScanTable() noexcept
+{
+    std::array<ScanTranslation, g_linuxScanCodeCount> table{};
+    for (std::size_t code = 0; code < table.size(); ++code)
+    {
+        table[code].scanCode = static_cast<std::uint32_t>(code);
+    }
+    return table;
+}
+
+// Dense tables indexed by qtKeyIndex() and evdev key code, so a lookup is one bounded load. A virtual key
+// of 0 means unmapped; unmapped scan codes translate to themselves.
 struct LinuxKeyMap
 {
-    std::unordered_map<std::uint64_t, std::uint32_t> qtKeyToVirtualKey;
-    std::unordered_map<std::uint32_t, ScanTranslation> linuxScanToWinScan;
+    std::array<std::uint8_t, g_qtKeyIndexCount> qtKeyToVirtualKey{};
+    std::array<ScanTranslation, g_linuxScanCodeCount> linuxScanToWinScan{ makeIdentityScanTable() };
     std::uint32_t nativeScanCodeOffset{};
 };
 
-std::uint64_t makeQtKeyMapKey(int qtKey, bool keypad);
+// Both return false when the key is outside the tables or the value does not fit.
+constexpr bool setQtKeyMapping(LinuxKeyMap& map, const QtKeyMapping& mapping) noexcept
+{
+    const auto index{ qtKeyIndex(mapping.qtKey, mapping.keypad) };
+    if (index >= map.qtKeyToVirtualKey.size() || mapping.virtualKey == 0 || mapping.virtualKey > 0xFF)
+    {
+        return false;
+    }
+    map.qtKeyToVirtualKey[index] = static_cast<std::uint8_t>(mapping.virtualKey);
+    return true;
+}
+
+constexpr bool setScanMapping(LinuxKeyMap& map, const ScanMapping& mapping) noexcept
+{
+    if (mapping.linuxScanCode >= map.linuxScanToWinScan.size())
+    {
+        return false;
+    }
+    map.linuxScanToWinScan[mapping.linuxScanCode] = ScanTranslation{ mapping.winScanCode, mapping.isExtended };
+    return true;
+}
+
+// The map compiled from resources/linux_keymap.json at build time.
+const LinuxKeyMap& bundledLinuxKeyMap();
+
 bool parseLinuxKeyMap(const QByteArray& data, LinuxKeyMap* outMap, std::vector<QString>* errors);
+bool loadLinuxKeyMap(const QString& path, LinuxKeyMap* outMap, QString* errorMessage);
+// The file named by g_keyMapOverrideVariable if set, the bundled map otherwise.
+bool loadConfiguredLinuxKeyMap(LinuxKeyMap* outMap, QString* errorMessage);
 QString formatErrors(const std::vector<QString>& errors);
 
+// Keypad keys fall back to the main-block mapping; returns 0 when neither is mapped.
+inline std::uint32_t lookupVirtualKey(const LinuxKeyMap& map, int qtKey, bool keypad) noexcept
+{
+    const auto index{ qtKeyIndex(qtKey, keypad) };
+    if (index >= map.qtKeyToVirtualKey.size())
+    {
+        return 0;
+    }
+    if (const auto virtualKey{ map.qtKeyToVirtualKey[index] }; virtualKey != 0 || !keypad)
+    {
+        return virtualKey;
+    }
+    return map.qtKeyToVirtualKey[index - 1];
+}
+
+// linuxScanCode is an evdev key code (X11 keycode minus nativeScanCodeOffset); unmapped codes pass through.
+inline ScanTranslation translateLinuxScanCode(const LinuxKeyMap& map, std::uint32_t linuxScanCode) noexcept
+{
+    if (linuxScanCode < map.linuxScanToWinScan.size())
+    {
+        return map.linuxScanToWinScan[linuxScanCode];
+    }
+    return ScanTranslation{ linuxScanCode, false };
+}
+
 } // namespace LinuxKeymapParser
 
 #endif // inputTesterPlatformLinuxKeymapParserH
@@ -17,10 +17,16 @@ namespace inputTester
 namespace
 {
 
-inputEvent makeKeyEvent(const RAWKEYBOARD& keyboard, std::uint32_t deviceId)
+// MSG::time only ticks every 10-16 ms (GetTickCount), far coarser than the intervals being measured, so the
+// receive time stands in for the source time.
+void stampReceived(inputEvent& event)
+{
+    event.receiveTimestampNs = nowTimestampNs();
+    event.sourceTimestampNs = event.receiveTimestampNs;
+}
+
+void makeKeyEvent(const RAWKEYBOARD& keyboard, std::uint32_t deviceId, inputEvent& keyEvent)
 {
-    inputEvent keyEvent{};
-    keyEvent.timestampNs = nowTimestampNs();
     keyEvent.deviceId = deviceId;
     keyEvent.device = deviceType::keyboard;
     keyEvent.kind = (keyboard.Flags & RI_KEY_BREAK) ? eventKind::keyUp : eventKind::keyDown;
@@ -28,7 +34,6 @@ inputEvent makeKeyEvent(const RAWKEYBOARD& keyboard, std::uint32_t deviceId)
     keyEvent.scanCode = static_cast<std::uint32_t>(keyboard.MakeCode);
     keyEvent.repeatCount = static_cast<std::uint16_t>(keyEvent.kind == eventKind::keyDown ? 1 : 0);
     keyEvent.isExtended = (keyboard.Flags & RI_KEY_E0) != 0 || (keyboard.Flags & RI_KEY_E1) != 0;
-    return keyEvent;
 }
 
 char32_t normalizeChar(wchar_t ch)
@@ -112,13 +117,17 @@ public:
             break;
         case WM_CHAR:
         {
-            inputEvent textEvent{};
-            textEvent.timestampNs = nowTimestampNs();
-            textEvent.device = deviceType::keyboard;
-            textEvent.kind = eventKind::keyDown;
-            textEvent.isTextEvent = true;
-            textEvent.text = normalizeChar(static_cast<wchar_t>(msg->wParam));
-            sink_->onInputEvent(textEvent);
+            inputEvent fallback{};
+            auto* textEvent{ reserveEvent(*sink_, fallback) };
+            if (textEvent != nullptr)
+            {
+                stampReceived(*textEvent);
+                textEvent->device = deviceType::keyboard;
+                textEvent->kind = eventKind::keyDown;
+                textEvent->isTextEvent = true;
+                textEvent->text = normalizeChar(static_cast<wchar_t>(msg->wParam));
+                commitEvent(*sink_, fallback);
+            }
             if (result != nullptr)
             {
                 *result = 0;
@@ -182,8 +191,15 @@ private:
         }
 
         const auto deviceId{ getDeviceId(raw->header.hDevice) };
-        const auto keyEvent{ makeKeyEvent(raw->data.keyboard, deviceId) };
-        sink_->onInputEvent(keyEvent);
+        inputEvent fallback{};
+        auto* slot{ reserveEvent(*sink_, fallback) };
+        if (slot == nullptr)
+        {
+            return;
+        }
+        stampReceived(*slot);
+        makeKeyEvent(raw->data.keyboard, deviceId, *slot);
+        commitEvent(*sink_, fallback);
     }
 
     std::uint32_t getDeviceId(HANDLE deviceHandle)
@@ -0,0 +1,109 @@
+#include "allocationTracker.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+
+// Sanitizer runtimes install their own malloc, so tracking is left off under them.
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define INPUTTESTER_SANITIZED 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer) || __has_feature(memory_sanitizer)
+#define INPUTTESTER_SANITIZED 1
+#endif
+#endif
+
+#if defined(__GLIBC__) && !defined(INPUTTESTER_SANITIZED)
+#define INPUTTESTER_ALLOCATION_TRACKING 1
+#else
+#define INPUTTESTER_ALLOCATION_TRACKING 0
+#endif
+
+namespace
+{
+
+// Trivial thread_local in the executable: reading it never allocates, so the hooks cannot recurse.
+thread_local std::uint64_t t_allocations{ 0 };
+std::atomic<std::uint64_t> g_allocations{ 0 };
+
+[[maybe_unused]] void countAllocation() noexcept
+{
+    ++t_allocations;
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+#if INPUTTESTER_ALLOCATION_TRACKING
+// glibc's own entry points; the definitions below shadow the public names for the whole process.
+extern "C"
+{
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pointer, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+
+void* malloc(std::size_t size)
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size)
+{
+    countAllocation();
+    return __libc_realloc(pointer, size);
+}
+
+void* memalign(std::size_t alignment, std::size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size)
+{
+    countAllocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** out, std::size_t alignment, std::size_t size)
+{
+    countAllocation();
+    void* pointer{ __libc_memalign(alignment, size) };
+    if (pointer == nullptr)
+    {
+        return ENOMEM;
+    }
+    *out = pointer;
+    return 0;
+}
+}
+#endif
+
+namespace allocationTracker
+{
+
+bool isActive() noexcept
+{
+    return INPUTTESTER_ALLOCATION_TRACKING != 0;
+}
+
+std::uint64_t threadAllocations() noexcept
+{
+    return t_allocations;
+}
+
+std::uint64_t processAllocations() noexcept
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace allocationTracker
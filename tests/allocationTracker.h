@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts heap allocations for tests and benchmarks that promise an allocation-free hot path. Linking
+// allocationTracker.cpp interposes the C allocator (malloc and friends, which operator new and Qt's containers
+// end up in), so allocations made inside libraries are counted too.
+namespace allocationTracker
+{
+
+// False where the allocator cannot be interposed (non-glibc, sanitizer builds); counts then stay at zero and
+// tests should skip rather than pass vacuously.
+bool isActive() noexcept;
+
+// Allocations made by the calling thread / by every thread since the process started.
+std::uint64_t threadAllocations() noexcept;
+std::uint64_t processAllocations() noexcept;
+
+// Scoped no-allocation region: counts the calling thread's allocations from construction on.
+class Region
+{
+public:
+    Region() noexcept : m_start{ threadAllocations() }
+    {
+    }
+
+    std::uint64_t allocations() const noexcept
+    {
+        return threadAllocations() - m_start;
+    }
+
+private:
+    std::uint64_t m_start;
+};
+
+} // namespace allocationTracker
@@ -0,0 +1,174 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <QTemporaryDir>
+#include <QtTest/QTest>
+
+#include "inputtester/core/blockWriter.h"
+
+namespace
+{
+
+constexpr std::size_t g_blockBytes{ 64 * 1'024 };
+constexpr std::size_t g_blockCount{ 200 };
+
+// Writes g_blockCount blocks, each filled with its own index, plus a short tail; returns what the file holds.
+std::vector<std::uint8_t> writeBlocks(inputTester::blockWriter& writer, const std::string& path)
+{
+    for (std::size_t block = 0; block < g_blockCount; ++block)
+    {
+        auto buffer{ writer.acquire() };
+        std::memset(buffer.data(), static_cast<int>(block & 0xFF), buffer.size());
+        writer.submit(buffer, buffer.size(), block * g_blockBytes);
+    }
+    auto tail{ writer.acquire() };
+    std::memset(tail.data(), 0xEE, 100);
+    writer.submit(tail, 100, g_blockCount * g_blockBytes);
+    writer.submit(writer.acquire(), 0, 0);
+
+    std::string error{};
+    if (!writer.flush(&error))
+    {
+        return {};
+    }
+    std::vector<std::uint8_t> contents(g_blockCount * g_blockBytes + 100);
+    std::FILE* file{ std::fopen(path.c_str(), "rb") };
+    if (file == nullptr || std::fread(contents.data(), 1, contents.size(), file) != contents.size())
+    {
+        contents.clear();
+    }
+    if (file != nullptr)
+    {
+        std::fclose(file);
+    }
+    return contents;
+}
+
+bool holdsBlocks(const std::vector<std::uint8_t>& contents)
+{
+    if (contents.size() != g_blockCount * g_blockBytes + 100)
+    {
+        return false;
+    }
+    for (std::size_t offset = 0; offset < contents.size(); ++offset)
+    {
+        const auto block{ offset / g_blockBytes };
+        const auto expected{ block < g_blockCount ? static_cast<std::uint8_t>(block & 0xFF) : std::uint8_t{ 0xEE } };
+        if (contents[offset] != expected)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+class blockWriterTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void threadBackendWritesEveryBlock();
+    void ioUringBackendWritesEveryBlock();
+    void reportsWriteFailures();
+    void rejectsForeignBuffers();
+};
+
+void blockWriterTests::threadBackendWritesEveryBlock()
+{
+    const QTemporaryDir directory{};
+    const auto path{ directory.filePath("thread.bin").toStdString() };
+    inputTester::outputFile file{};
+    QVERIFY(file.open(path, nullptr));
+    const auto writer{ inputTester::blockWriter::create(file, g_blockBytes, 3,
+                                                         inputTester::blockWriterBackend::thread) };
+    QCOMPARE(writer->backend(), inputTester::blockWriterBackend::thread);
+
+    QVERIFY(holdsBlocks(writeBlocks(*writer, path)));
+    const auto stats{ writer->stats() };
+    QCOMPARE(stats.blocksWritten, std::uint64_t{ g_blockCount + 1 });
+    QCOMPARE(stats.bytesWritten, std::uint64_t{ g_blockCount * g_blockBytes + 100 });
+    QCOMPARE(stats.inFlight, std::size_t{ 0 });
+    QVERIFY(stats.peakInFlight <= 3);
+    QVERIFY(!stats.failed);
+}
+
+void blockWriterTests::ioUringBackendWritesEveryBlock()
+{
+    const QTemporaryDir directory{};
+    const auto path{ directory.filePath("ring.bin").toStdString() };
+    inputTester::outputFile file{};
+    QVERIFY(file.open(path, nullptr));
+    const auto writer{ inputTester::blockWriter::create(file, g_blockBytes, 4,
+                                                         inputTester::blockWriterBackend::ioUring) };
+    if (writer->backend() != inputTester::blockWriterBackend::ioUring)
+    {
+        QSKIP("io_uring is not available here; the thread backend is covered separately");
+    }
+
+    QVERIFY(holdsBlocks(writeBlocks(*writer, path)));
+    QCOMPARE(writer->stats().blocksWritten, std::uint64_t{ g_blockCount + 1 });
+    QCOMPARE(writer->stats().inFlight, std::size_t{ 0 });
+}
+
+void blockWriterTests::reportsWriteFailures()
+{
+#if defined(__linux__)
+    for (const auto backend : { inputTester::blockWriterBackend::thread, inputTester::blockWriterBackend::ioUring })
+    {
+        // Every write to /dev/full fails with ENOSPC.
+        inputTester::outputFile file{};
+        QVERIFY(file.open("/dev/full", nullptr));
+        const auto writer{ inputTester::blockWriter::create(file, g_blockBytes, 2, backend) };
+        for (std::size_t block = 0; block < 4; ++block)
+        {
+            writer->submit(writer->acquire(), g_blockBytes, block * g_blockBytes);
+        }
+        std::string error{};
+        QVERIFY(!writer->flush(&error));
+        QVERIFY(!error.empty());
+        QVERIFY(writer->stats().failed);
+        QCOMPARE(writer->stats().bytesWritten, std::uint64_t{ 0 });
+
+        writer->reset();
+        QVERIFY(!writer->stats().failed);
+    }
+#else
+    QSKIP("needs /dev/full");
+#endif
+}
+
+void blockWriterTests::rejectsForeignBuffers()
+{
+    const QTemporaryDir directory{};
+    const auto path{ directory.filePath("foreign.bin").toStdString() };
+    inputTester::outputFile file{};
+    QVERIFY(file.open(path, nullptr));
+    const auto writer{ inputTester::blockWriter::create(file, g_blockBytes, 2,
+                                                         inputTester::blockWriterBackend::thread) };
+    std::vector<std::byte> foreign(g_blockBytes);
+    writer->submit(foreign, foreign.size(), 0);
+    std::string error{};
+    QVERIFY(!writer->flush(&error));
+    QVERIFY(!error.empty());
+    QCOMPARE(writer->stats().inFlight, std::size_t{ 0 });
+
+    // Nothing went back to the pool in its place: both buffers are free, and no third one appears.
+    writer->reset();
+    const auto first{ writer->acquire() };
+    const auto second{ writer->acquire() };
+    QVERIFY(first.data() != second.data());
+    QCOMPARE(writer->stats().stalls, std::uint64_t{ 0 });
+    writer->submit(first, 0, 0);
+    writer->submit(second, 0, 0);
+    QVERIFY(writer->flush());
+}
+
+QTEST_GUILESS_MAIN(blockWriterTests)
+
+#include "blockWriterTests.moc"
@@ -0,0 +1,262 @@
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <QTemporaryDir>
+#include <QtTest/QTest>
+
+#include "inputtester/core/captureFile.h"
+#include "inputtester/core/inputEventTee.h"
+
+namespace
+{
+
+constexpr std::uint64_t g_msNs{ 1'000'000 };
+
+inputTester::inputEvent keyEvent(std::uint32_t deviceId, std::uint32_t scanCode, bool pressed,
+                                 std::uint64_t timestampNs)
+{
+    inputTester::inputEvent event{};
+    event.sourceTimestampNs = timestampNs;
+    event.receiveTimestampNs = timestampNs + 50'000;
+    event.deviceId = deviceId;
+    event.device = inputTester::deviceType::keyboard;
+    event.kind = pressed ? inputTester::eventKind::keyDown : inputTester::eventKind::keyUp;
+    event.scanCode = scanCode;
+    return event;
+}
+
+bool sameEvent(const inputTester::inputEvent& left, const inputTester::inputEvent& right)
+{
+    return left.sourceTimestampNs == right.sourceTimestampNs &&
+           left.receiveTimestampNs == right.receiveTimestampNs && left.deviceId == right.deviceId &&
+           left.device == right.device && left.kind == right.kind && left.virtualKey == right.virtualKey &&
+           left.scanCode == right.scanCode && left.repeatCount == right.repeatCount &&
+           left.isExtended == right.isExtended && left.isTextEvent == right.isTextEvent && left.text == right.text;
+}
+
+std::vector<inputTester::inputEvent> readAll(const inputTester::captureReader& reader)
+{
+    std::vector<inputTester::inputEvent> events{};
+    reader.forEachEvent([&events](const inputTester::inputEvent& event) { events.push_back(event); });
+    return events;
+}
+
+} // namespace
+
+class captureFileTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTripsEveryField();
+    void listsDevices();
+    void readsUnclosedCapture();
+    void rejectsOtherFiles();
+    void mergesConcurrentProducers();
+};
+
+void captureFileTests::roundTripsEveryField()
+{
+    const QTemporaryDir directory{};
+    const auto path{ directory.filePath("session.itcap").toStdString() };
+    const auto baseNs{ inputTester::nowTimestampNs() };
+
+    std::vector<inputTester::inputEvent> written{};
+    for (std::uint32_t index = 0; index < 5'000; ++index)
+    {
+        written.push_back(keyEvent(1, 0x10 + index % 32, index % 2 == 0, baseNs + index * 125'000));
+    }
+    // The first two need the escaped form.
+    auto wide{ keyEvent(2, 0x1234, true, baseNs + 700 * g_msNs) };
+    wide.repeatCount = 7;
+    wide.virtualKey = 0x1FF;
+    written.push_back(wide);
+    auto late{ keyEvent(1, 0x1E, false, baseNs + 701 * g_msNs) };
+    late.receiveTimestampNs = late.sourceTimestampNs + 500 * g_msNs;
+    written.push_back(late);
+    auto text{ keyEvent(1, 0, true, baseNs + 702 * g_msNs) };
+    text.isTextEvent = true;
+    text.text = U'\U0001F600';
+    written.push_back(text);
+
+    {
+        inputTester::captureWriter writer{};
+        std::string error{};
+        QVERIFY(writer.open(path, &error));
+        for (const auto& event : written)
+        {
+            writer.onInputEvent(event);
+        }
+        QVERIFY(writer.close(&error));
+        QCOMPARE(writer.stats().eventsWritten, std::uint64_t{ written.size() });
+        QCOMPARE(writer.stats().dropped, std::uint64_t{ 0 });
+    }
+
+    inputTester::captureReader reader{};
+    std::string error{};
+    QVERIFY(reader.open(path, &error));
+    QVERIFY(reader.isComplete());
+    QCOMPARE(reader.header().eventCount, std::uint64_t{ written.size() });
+    QCOMPARE(reader.packedSlots().size(), written.size() - 2 + 2 * inputTester::escapedSlotCount);
+    const auto events{ readAll(reader) };
+    QCOMPARE(events.size(), written.size());
+    for (std::size_t index = 0; index < events.size(); ++index)
+    {
+        QVERIFY(sameEvent(events[index], written[index]));
+    }
+}
+
+void captureFileTests::listsDevices()
+{
+    const QTemporaryDir directory{};
+    const auto path{ directory.filePath("devices.itcap").toStdString() };
+    const auto baseNs{ inputTester::nowTimestampNs() };
+    {
+        inputTester::captureWriter writer{};
+        QVERIFY(writer.open(path, nullptr));
+        writer.onInputEvent(keyEvent(3, 0x1E, true, baseNs));
+        writer.onInputEvent(keyEvent(5, 0x1E, true, baseNs + g_msNs));
+        writer.onInputEvent(keyEvent(3, 0x1E, false, baseNs + 2 * g_msNs));
+        QVERIFY(writer.close());
+    }
+
+    inputTester::captureReader reader{};
+    QVERIFY(reader.open(path, nullptr));
+    const auto devices{ reader.devices() };
+    QCOMPARE(devices.size(), std::size_t{ 2 });
+    QCOMPARE(devices[0].deviceId, 3U);
+    QCOMPARE(devices[0].eventCount, std::uint64_t{ 2 });
+    QCOMPARE(devices[0].firstTimestampNs, baseNs);
+    QCOMPARE(devices[0].lastTimestampNs, baseNs + 2 * g_msNs);
+    QCOMPARE(devices[1].deviceId, 5U);
+    QCOMPARE(devices[1].device, inputTester::deviceType::keyboard);
+}
+
+void captureFileTests::readsUnclosedCapture()
+{
+    const QTemporaryDir directory{};
+    const auto path{ directory.filePath("crashed.itcap").toStdString() };
+    const auto baseNs{ inputTester::nowTimestampNs() };
+    {
+        inputTester::captureWriter writer{};
+        QVERIFY(writer.open(path, nullptr));
+        for (std::uint32_t index = 0; index < 100; ++index)
+        {
+            writer.onInputEvent(keyEvent(1, 0x1E, index % 2 == 0, baseNs + index * g_msNs));
+        }
+        QVERIFY(writer.close());
+    }
+
+    // What a crash leaves behind: the provisional header, the slots that made it out, and half a slot.
+    inputTester::captureFileHeader header{};
+    {
+        std::FILE* file{ std::fopen(path.c_str(), "r+b") };
+        QVERIFY(file != nullptr);
+        QCOMPARE(std::fread(&header, sizeof(header), 1, file), std::size_t{ 1 });
+        const auto slotCount{ header.slotCount };
+        header.slotCount = 0;
+        header.eventCount = 0;
+        header.deviceTableOffset = 0;
+        header.deviceCount = 0;
+        header.flags = 0;
+        std::fseek(file, 0, SEEK_SET);
+        std::fwrite(&header, sizeof(header), 1, file);
+        std::fclose(file);
+        const auto slotBytes{ slotCount * sizeof(inputTester::packedInputEvent) };
+        std::filesystem::resize_file(path, header.recordsOffset + slotBytes - 8);
+    }
+
+    inputTester::captureReader reader{};
+    QVERIFY(reader.open(path, nullptr));
+    QVERIFY(!reader.isComplete());
+    QVERIFY(reader.devices().empty());
+    const auto events{ readAll(reader) };
+    QCOMPARE(events.size(), std::size_t{ 99 });
+    QCOMPARE(events.back().sourceTimestampNs, baseNs + 98 * g_msNs);
+}
+
+void captureFileTests::rejectsOtherFiles()
+{
+    const QTemporaryDir directory{};
+    const auto path{ directory.filePath("other.bin").toStdString() };
+    {
+        std::FILE* file{ std::fopen(path.c_str(), "wb") };
+        QVERIFY(file != nullptr);
+        const std::vector<char> junk(8'192, 'x');
+        std::fwrite(junk.data(), 1, junk.size(), file);
+        std::fclose(file);
+    }
+
+    inputTester::captureReader reader{};
+    std::string error{};
+    QVERIFY(!reader.open(path, &error));
+    QVERIFY(!error.empty());
+    QVERIFY(!reader.open(directory.filePath("missing.itcap").toStdString(), &error));
+    QVERIFY(reader.packedSlots().empty());
+}
+
+void captureFileTests::mergesConcurrentProducers()
+{
+    const QTemporaryDir directory{};
+    const auto path{ directory.filePath("producers.itcap").toStdString() };
+    constexpr std::uint32_t producerCount{ 4 };
+    constexpr std::uint32_t eventsPerProducer{ 20'000 };
+
+    inputTester::captureWriterOptions options{};
+    options.blockBytes = 64 * 1'024;
+    options.drainInterval = std::chrono::milliseconds{ 1 };
+    inputTester::captureWriter writer{ options };
+    // Written through a tee, so both files must end up with every event.
+    inputTester::captureWriter mirror{ options };
+    const auto mirrorPath{ directory.filePath("mirror.itcap").toStdString() };
+    QVERIFY(writer.open(path, nullptr));
+    QVERIFY(mirror.open(mirrorPath, nullptr));
+    inputTester::inputEventTee tee{ writer, mirror };
+
+    std::vector<std::thread> producers{};
+    for (std::uint32_t producer = 0; producer < producerCount; ++producer)
+    {
+        producers.emplace_back(
+            [&tee, producer]()
+            {
+                for (std::uint32_t index = 0; index < eventsPerProducer; ++index)
+                {
+                    auto* event{ tee.reserveEvent() };
+                    *event = keyEvent(producer, 0x10, index % 2 == 0, inputTester::nowTimestampNs());
+                    tee.commitEvent();
+                    if (index % 64 == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    QVERIFY(writer.close());
+    QVERIFY(mirror.close());
+
+    for (const auto& capturePath : { path, mirrorPath })
+    {
+        inputTester::captureReader reader{};
+        QVERIFY(reader.open(capturePath, nullptr));
+        QCOMPARE(reader.devices().size(), std::size_t{ producerCount });
+        std::vector<std::uint32_t> perProducer(producerCount, 0);
+        const auto count{ reader.forEachEvent([&perProducer](const inputTester::inputEvent& event)
+                                              { ++perProducer[event.deviceId]; }) };
+        QCOMPARE(count, std::size_t{ producerCount * eventsPerProducer });
+        for (const auto events : perProducer)
+        {
+            QCOMPARE(events, eventsPerProducer);
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(captureFileTests)
+
+#include "captureFileTests.moc"
@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include "inputtester/core/blockWriter.h"
+#include "inputtester/core/captureFile.h"
+#include "inputtester/core/inputEvent.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#if !defined(__linux__)
+#error "tests/captureWriterBench.cpp is intended to run on Linux only."
+#endif
+
+#include <unistd.h>
+
+namespace
+{
+using steadyClock = std::chrono::steady_clock;
+
+// tmpfs by default, so the numbers measure the writer rather than the disk; CAPTURE_BENCH_DIR picks another place.
+std::string capturePath()
+{
+    const char* directory = std::getenv("CAPTURE_BENCH_DIR");
+    std::string path = directory != nullptr ? directory : "/dev/shm";
+    path += "/captureWriterBench-" + std::to_string(::getpid()) + ".itcap";
+    return path;
+}
+} // namespace
+
+// Feeds a captureWriter N events per second for D ms, paced in 1 ms batches, through the given blockWriter backend
+// (0 = write thread, 1 = io_uring). Everything produced should reach the file: dropped must stay 0.
+static void bmCaptureWriterRate(benchmark::State& state)
+{
+    const auto backend = static_cast<inputTester::blockWriterBackend>(state.range(0));
+    const auto eventsPerSecond = static_cast<std::uint64_t>(state.range(1));
+    const auto durationMs = static_cast<std::uint64_t>(state.range(2));
+    const std::uint64_t eventsPerBatch = eventsPerSecond / 1000;
+    const std::string path = capturePath();
+
+    inputTester::captureWriterOptions options{};
+    options.backend = backend;
+    inputTester::captureWriter writer{ options };
+
+    inputTester::captureWriterStats stats{};
+    std::uint64_t produced = 0;
+    for (auto _ : state)
+    {
+        std::string error;
+        if (!writer.open(path, &error))
+        {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+
+        auto next = steadyClock::now();
+        const auto end = next + std::chrono::milliseconds(durationMs);
+        while (next < end)
+        {
+            for (std::uint64_t i = 0; i < eventsPerBatch; ++i)
+            {
+                inputTester::inputEvent* event = writer.reserveEvent();
+                if (event == nullptr)
+                {
+                    continue;
+                }
+                event->sourceTimestampNs = inputTester::nowTimestampNs();
+                event->receiveTimestampNs = event->sourceTimestampNs;
+                event->deviceId = 1;
+                event->device = inputTester::deviceType::mouse;
+                event->kind = inputTester::eventKind::motion;
+                event->scanCode = static_cast<std::uint32_t>(produced & 0xFFF);
+                writer.commitEvent();
+                ++produced;
+            }
+            next += std::chrono::milliseconds(1);
+            std::this_thread::sleep_until(next);
+        }
+
+        stats = writer.stats();
+        if (!writer.close(&error))
+        {
+            state.SkipWithError(error.c_str());
+            break;
+        }
+    }
+    std::remove(path.c_str());
+
+    state.counters["backend"] = static_cast<double>(stats.backend);
+    state.counters["events/sec"] = benchmark::Counter(double(produced), benchmark::Counter::kIsRate);
+    state.counters["MB/sec"] = stats.bytesPerSecond / 1e6;
+    state.counters["dropped"] = static_cast<double>(stats.dropped);
+    state.counters["queued_peak"] = static_cast<double>(stats.queuedEventsPeak);
+    state.counters["blocks_in_flight_peak"] = static_cast<double>(stats.blocksInFlightPeak);
+    state.counters["stalls"] = static_cast<double>(stats.stalls);
+}
+
+BENCHMARK(bmCaptureWriterRate)
+    ->Args({ 0, 1'000'000, 2000 })
+    ->Args({ 1, 1'000'000, 2000 })
+    ->Args({ 0, 4'000'000, 2000 })
+    ->Args({ 1, 4'000'000, 2000 })
+    ->Iterations(1)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,133 @@
+#include <cstdint>
+
+#include <QtTest/QTest>
+
+#include "inputtester/core/chatterDetector.h"
+
+namespace
+{
+
+constexpr std::uint64_t g_msNs{ 1'000'000 };
+constexpr std::uint32_t g_keyA{ 0x1E };
+constexpr std::uint32_t g_keyB{ 0x30 };
+
+} // namespace
+
+class chatterDetectorTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void ignoresOrdinaryTyping();
+    void flagsQuickRepress();
+    void ignoresAutoRepeatAndStrayReleases();
+    void keepsUpWithBursts();
+    void resetClearsEverything();
+};
+
+void chatterDetectorTests::ignoresOrdinaryTyping()
+{
+    inputTester::chatterDetector detector{};
+    std::uint64_t now{ g_msNs };
+    for (int press = 0; press < 10; ++press)
+    {
+        QVERIFY(!detector.record(g_keyA, true, now));
+        QVERIFY(!detector.record(g_keyA, false, now + 80 * g_msNs));
+        now += 150 * g_msNs;
+    }
+
+    const auto stats{ detector.stats(g_keyA) };
+    QCOMPARE(stats.presses, 10U);
+    QCOMPARE(stats.bounces, 0U);
+    QCOMPARE(stats.minReleaseToPressNs, 70 * g_msNs);
+    QVERIFY(!detector.isChattering(g_keyA));
+    QCOMPARE(detector.stats(g_keyB).minReleaseToPressNs, inputTester::keyChatterStats::noInterval);
+}
+
+void chatterDetectorTests::flagsQuickRepress()
+{
+    inputTester::chatterDetector detector{};
+    // Down, up 40 ms later, then down again 2 ms after the release.
+    QVERIFY(!detector.record(g_keyA, true, 100 * g_msNs));
+    QVERIFY(!detector.record(g_keyA, false, 140 * g_msNs));
+    QVERIFY(detector.record(g_keyA, true, 142 * g_msNs));
+    QVERIFY(!detector.record(g_keyA, false, 200 * g_msNs));
+    // Same-poll release and press.
+    QVERIFY(detector.record(g_keyA, true, 200 * g_msNs));
+    QVERIFY(!detector.record(g_keyB, true, 200 * g_msNs));
+
+    const auto stats{ detector.stats(g_keyA) };
+    QCOMPARE(stats.bounces, 2U);
+    QCOMPARE(stats.minReleaseToPressNs, std::uint64_t{ 0 });
+    QCOMPARE(stats.lastBounceNs, 200 * g_msNs);
+    QVERIFY(detector.isChattering(g_keyA));
+    QVERIFY(!detector.isChattering(g_keyB));
+    QCOMPARE(detector.totalBounces(), std::uint64_t{ 2 });
+    QCOMPARE(detector.chatteringKeyCount(), std::size_t{ 1 });
+}
+
+void chatterDetectorTests::ignoresAutoRepeatAndStrayReleases()
+{
+    inputTester::chatterDetector detector{ 5 * g_msNs };
+    QVERIFY(!detector.record(g_keyA, false, g_msNs));
+    QVERIFY(!detector.record(g_keyA, true, 2 * g_msNs));
+    for (std::uint64_t repeat = 1; repeat <= 20; ++repeat)
+    {
+        QVERIFY(!detector.record(g_keyA, true, 2 * g_msNs + repeat * 30 * g_msNs));
+    }
+    QVERIFY(!detector.record(g_keyA, false, 700 * g_msNs));
+    // Outside the 5 ms window.
+    QVERIFY(!detector.record(g_keyA, true, 706 * g_msNs));
+    QVERIFY(!detector.record(inputTester::chatterDetector::keyCount, true, 706 * g_msNs));
+
+    QCOMPARE(detector.stats(g_keyA).presses, 2U);
+    QCOMPARE(detector.totalBounces(), std::uint64_t{ 0 });
+}
+
+void chatterDetectorTests::keepsUpWithBursts()
+{
+    // 100k transitions over 64 keys, one every 10 us, as a synthetic chattering board would produce.
+    inputTester::chatterDetector detector{};
+    constexpr std::uint32_t keys{ 64 };
+    constexpr std::uint64_t rounds{ 100'000 / (2 * keys) };
+    std::uint64_t now{ g_msNs };
+    std::uint64_t reported{ 0 };
+    for (std::uint64_t round = 0; round < rounds; ++round)
+    {
+        for (const bool pressed : { true, false })
+        {
+            for (std::uint32_t key = 0; key < keys; ++key)
+            {
+                reported += detector.record(key, pressed, now) ? 1 : 0;
+                now += 10'000;
+            }
+        }
+    }
+
+    QCOMPARE(detector.totalBounces(), keys * (rounds - 1));
+    QCOMPARE(reported, detector.totalBounces());
+    QCOMPARE(detector.chatteringKeyCount(), std::size_t{ keys });
+    QCOMPARE(detector.stats(0).minReleaseToPressNs, std::uint64_t{ keys * 10'000 });
+}
+
+void chatterDetectorTests::resetClearsEverything()
+{
+    inputTester::chatterDetector detector{};
+    detector.record(g_keyA, true, g_msNs);
+    detector.record(g_keyA, false, 2 * g_msNs);
+    detector.record(g_keyA, true, 3 * g_msNs);
+    QVERIFY(detector.isChattering(g_keyA));
+
+    detector.reset();
+    QVERIFY(!detector.isChattering(g_keyA));
+    QCOMPARE(detector.totalBounces(), std::uint64_t{ 0 });
+    QCOMPARE(detector.chatteringKeyCount(), std::size_t{ 0 });
+    QCOMPARE(detector.stats(g_keyA).presses, 0U);
+    // The key counted as held before the reset does not leak into the next press.
+    QVERIFY(!detector.record(g_keyA, true, 4 * g_msNs));
+    QCOMPARE(detector.stats(g_keyA).presses, 1U);
+}
+
+QTEST_GUILESS_MAIN(chatterDetectorTests)
+
+#include "chatterDetectorTests.moc"
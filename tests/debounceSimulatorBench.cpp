@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+
+#include "inputtester/core/debounceSimulator.h"
+#include "inputtester/core/inputEvent.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+constexpr std::uint64_t g_msNs = 1'000'000;
+constexpr std::size_t g_eventCount = 5'000'000;
+
+// The four schemes at a 5 ms and a 10 ms window.
+constexpr std::array<inputTester::debounceModel, 8> g_models{ {
+    { inputTester::debounceAlgorithm::symmetricEager, 5 * g_msNs },
+    { inputTester::debounceAlgorithm::symmetricDeferred, 5 * g_msNs },
+    { inputTester::debounceAlgorithm::globalDeferred, 5 * g_msNs },
+    { inputTester::debounceAlgorithm::asymmetricEagerDeferred, 5 * g_msNs },
+    { inputTester::debounceAlgorithm::symmetricEager, 10 * g_msNs },
+    { inputTester::debounceAlgorithm::symmetricDeferred, 10 * g_msNs },
+    { inputTester::debounceAlgorithm::globalDeferred, 10 * g_msNs },
+    { inputTester::debounceAlgorithm::asymmetricEagerDeferred, 10 * g_msNs },
+} };
+
+// Fast typing with chatter: overlapping presses across 64 keys, and every eighth edge followed by a bounce
+// 0.5-2 ms later, so each model has bursts to settle and edges to suppress.
+std::vector<inputTester::inputEvent> makeRecording()
+{
+    std::vector<inputTester::inputEvent> events;
+    events.reserve(g_eventCount);
+    std::array<bool, 64> down{};
+    std::uint64_t nowNs = 0;
+    std::uint32_t state = 0x12345678;
+    const auto push = [&events](std::uint32_t key, bool pressed, std::uint64_t timestampNs) {
+        inputTester::inputEvent event{};
+        event.sourceTimestampNs = timestampNs;
+        event.receiveTimestampNs = timestampNs;
+        event.device = inputTester::deviceType::keyboard;
+        event.kind = pressed ? inputTester::eventKind::keyDown : inputTester::eventKind::keyUp;
+        event.scanCode = key + 1;
+        events.push_back(event);
+    };
+    while (events.size() + 3 <= g_eventCount)
+    {
+        state = state * 1'664'525U + 1'013'904'223U;
+        const std::uint32_t key = (state >> 8) % down.size();
+        nowNs += g_msNs + (state >> 20) % (20 * g_msNs);
+        down[key] = !down[key];
+        push(key, down[key], nowNs);
+        if ((state & 7) == 0)
+        {
+            const std::uint64_t bounceNs = g_msNs / 2 + (state >> 12) % (3 * g_msNs / 2);
+            push(key, !down[key], nowNs + bounceNs);
+            push(key, down[key], nowNs + bounceNs + g_msNs / 4);
+            nowNs += bounceNs + g_msNs / 4;
+        }
+    }
+    return events;
+}
+} // namespace
+
+// Replays 5 M recorded key edges through eight models; arg 0 = sequential, 1 = parallel. The README's
+// throughput figure is the sequential row: real_time per iteration is the time for the whole replay.
+static void bmDebounceReplay(benchmark::State& state)
+{
+    const auto execution = static_cast<inputTester::debounceExecution>(state.range(0));
+    static const std::vector<inputTester::inputEvent> events = makeRecording();
+
+    std::uint64_t suppressed = 0;
+    for (auto _ : state)
+    {
+        const auto reports = inputTester::simulateDebounce(events, g_models, execution);
+        suppressed = 0;
+        for (const auto& report : reports)
+        {
+            suppressed += report.suppressedTransitions;
+        }
+        benchmark::DoNotOptimize(suppressed);
+    }
+
+    state.counters["events"] = static_cast<double>(events.size());
+    state.counters["models"] = static_cast<double>(g_models.size());
+    state.counters["events/sec"] = benchmark::Counter(static_cast<double>(events.size()) * state.iterations(),
+                                                      benchmark::Counter::kIsRate);
+    state.counters["suppressed"] = static_cast<double>(suppressed);
+}
+
+BENCHMARK(bmDebounceReplay)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,187 @@
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <QtTest/QTest>
+
+#include "inputtester/core/debounceSimulator.h"
+
+namespace
+{
+
+constexpr std::uint64_t g_msNs{ 1'000'000 };
+constexpr std::uint64_t g_windowNs{ 5 * g_msNs };
+constexpr std::uint32_t g_keyA{ 0x1E };
+constexpr std::uint32_t g_keyB{ 0x30 };
+
+constexpr std::array<inputTester::debounceModel, 4> g_models{ {
+    { inputTester::debounceAlgorithm::symmetricEager, g_windowNs },
+    { inputTester::debounceAlgorithm::symmetricDeferred, g_windowNs },
+    { inputTester::debounceAlgorithm::globalDeferred, g_windowNs },
+    { inputTester::debounceAlgorithm::asymmetricEagerDeferred, g_windowNs },
+} };
+
+enum modelIndex : std::size_t
+{
+    eager = 0,
+    deferred,
+    global,
+    asymmetric,
+};
+
+inputTester::inputEvent keyEvent(std::uint32_t scanCode, bool pressed, std::uint64_t timestampNs)
+{
+    inputTester::inputEvent event{};
+    event.sourceTimestampNs = timestampNs;
+    event.receiveTimestampNs = timestampNs;
+    event.device = inputTester::deviceType::keyboard;
+    event.kind = pressed ? inputTester::eventKind::keyDown : inputTester::eventKind::keyUp;
+    event.scanCode = scanCode;
+    return event;
+}
+
+std::vector<inputTester::debounceReport> simulate(const std::vector<inputTester::inputEvent>& events)
+{
+    return inputTester::simulateDebounce(events, g_models);
+}
+
+} // namespace
+
+class debounceSimulatorTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanPressesPassThrough();
+    void filtersPressChatter();
+    void eagerReportsChangesAfterTheLockout();
+    void globalTimerWaitsForTheWholeBoard();
+    void skipsRepeatsAndOtherEvents();
+    void parallelMatchesSequential();
+};
+
+void debounceSimulatorTests::cleanPressesPassThrough()
+{
+    const auto reports{ simulate({ keyEvent(g_keyA, true, 100 * g_msNs), keyEvent(g_keyA, false, 180 * g_msNs) }) };
+
+    for (const auto& report : reports)
+    {
+        QCOMPARE(report.rawTransitions, std::uint64_t{ 2 });
+        QCOMPARE(report.reportedTransitions, std::uint64_t{ 2 });
+        QCOMPARE(report.suppressedTransitions, std::uint64_t{ 0 });
+    }
+    QCOMPARE(reports[eager].maxAddedLatencyNs, std::uint64_t{ 0 });
+    QCOMPARE(reports[deferred].meanAddedLatencyNs, static_cast<double>(g_windowNs));
+    QCOMPARE(reports[global].maxAddedLatencyNs, g_windowNs);
+    // The press goes out at once, the release after the window.
+    QCOMPARE(reports[asymmetric].meanAddedLatencyNs, static_cast<double>(g_windowNs) / 2.0);
+    QCOMPARE(reports[asymmetric].maxAddedLatencyNs, g_windowNs);
+}
+
+void debounceSimulatorTests::filtersPressChatter()
+{
+    // Contact bounces 1 ms after the press, then settles.
+    const auto reports{ simulate({ keyEvent(g_keyA, true, 0), keyEvent(g_keyA, false, g_msNs),
+                                   keyEvent(g_keyA, true, 2 * g_msNs), keyEvent(g_keyA, false, 60 * g_msNs) }) };
+
+    for (const auto& report : reports)
+    {
+        QCOMPARE(report.reportedTransitions, std::uint64_t{ 2 });
+        QCOMPARE(report.suppressedTransitions, std::uint64_t{ 2 });
+        QCOMPARE(report.keys.size(), std::size_t{ 1 });
+        QCOMPARE(report.keys[0].keyId, g_keyA);
+        QCOMPARE(report.keys[0].suppressedTransitions, std::uint64_t{ 2 });
+    }
+    QCOMPARE(reports[eager].maxAddedLatencyNs, std::uint64_t{ 0 });
+    // Counted from the first contact: the press waits out the bounce and then the window.
+    QCOMPARE(reports[deferred].keys[0].maxAddedLatencyNs, 7 * g_msNs);
+    QCOMPARE(reports[deferred].keys[0].totalAddedLatencyNs, 12 * g_msNs);
+    QCOMPARE(reports[asymmetric].keys[0].totalAddedLatencyNs, g_windowNs);
+}
+
+void debounceSimulatorTests::eagerReportsChangesAfterTheLockout()
+{
+    // Released 2 ms into the 5 ms lockout that followed the press.
+    const auto reports{ simulate({ keyEvent(g_keyA, true, 10 * g_msNs), keyEvent(g_keyA, false, 12 * g_msNs) }) };
+
+    QCOMPARE(reports[eager].reportedTransitions, std::uint64_t{ 2 });
+    QCOMPARE(reports[eager].maxAddedLatencyNs, 3 * g_msNs);
+}
+
+void debounceSimulatorTests::globalTimerWaitsForTheWholeBoard()
+{
+    const auto reports{ simulate({ keyEvent(g_keyA, true, 0), keyEvent(g_keyB, true, 3 * g_msNs),
+                                   keyEvent(g_keyA, false, 100 * g_msNs), keyEvent(g_keyB, false, 200 * g_msNs) }) };
+
+    // B's press restarts the shared timer, holding A's press back until 8 ms.
+    QCOMPARE(reports[global].maxAddedLatencyNs, 8 * g_msNs);
+    QCOMPARE(reports[global].meanAddedLatencyNs, static_cast<double>(8 + 5 + 5 + 5) * g_msNs / 4.0);
+    QCOMPARE(reports[deferred].maxAddedLatencyNs, g_windowNs);
+}
+
+void debounceSimulatorTests::skipsRepeatsAndOtherEvents()
+{
+    std::vector<inputTester::inputEvent> events{ keyEvent(g_keyA, true, 0) };
+    for (std::uint64_t repeat = 1; repeat <= 5; ++repeat)
+    {
+        auto event{ keyEvent(g_keyA, true, repeat * 30 * g_msNs) };
+        event.repeatCount = static_cast<std::uint16_t>(repeat);
+        events.push_back(event);
+    }
+    auto text{ keyEvent(g_keyA, false, 200 * g_msNs) };
+    text.isTextEvent = true;
+    events.push_back(text);
+    auto mouse{ keyEvent(g_keyA, false, 200 * g_msNs) };
+    mouse.device = inputTester::deviceType::mouse;
+    events.push_back(mouse);
+    auto extended{ keyEvent(g_keyA, true, 250 * g_msNs) };
+    extended.isExtended = true;
+    events.push_back(extended);
+    events.push_back(keyEvent(inputTester::debounceSimulator::keyCount, true, 260 * g_msNs));
+    events.push_back(keyEvent(g_keyA, false, 300 * g_msNs));
+
+    const auto reports{ simulate(events) };
+    QCOMPARE(reports[deferred].rawTransitions, std::uint64_t{ 3 });
+    QCOMPARE(reports[deferred].keys.size(), std::size_t{ 2 });
+    QCOMPARE(reports[deferred].keys[0].rawTransitions, std::uint64_t{ 2 });
+    QCOMPARE(reports[deferred].keys[1].keyId, g_keyA + inputTester::debounceSimulator::extendedKeyOffset);
+}
+
+void debounceSimulatorTests::parallelMatchesSequential()
+{
+    // 64 keys typing with occasional bounces, some landing inside the window and some just outside it.
+    std::vector<inputTester::inputEvent> events{};
+    std::uint64_t timestampNs{ 0 };
+    std::uint64_t state{ 12'345 };
+    std::array<bool, 64> down{};
+    for (int index = 0; index < 100'000; ++index)
+    {
+        state = state * 6'364'136'223'846'793'005ULL + 1'442'695'040'888'963'407ULL;
+        const auto key{ static_cast<std::uint32_t>(state >> 58) };
+        timestampNs += (state >> 40) % (8 * g_msNs);
+        down[key] = !down[key];
+        events.push_back(keyEvent(key, down[key], timestampNs));
+    }
+
+    std::vector<inputTester::debounceModel> models{ g_models.begin(), g_models.end() };
+    models.push_back({ inputTester::debounceAlgorithm::symmetricDeferred, 20 * g_msNs });
+    models.push_back({ inputTester::debounceAlgorithm::symmetricEager, g_msNs });
+    const auto sequential{ inputTester::simulateDebounce(events, models, inputTester::debounceExecution::sequential) };
+    const auto parallel{ inputTester::simulateDebounce(events, models, inputTester::debounceExecution::parallel) };
+
+    QCOMPARE(parallel.size(), models.size());
+    for (std::size_t model = 0; model < models.size(); ++model)
+    {
+        QCOMPARE(parallel[model].model.algorithm, models[model].algorithm);
+        QCOMPARE(parallel[model].model.windowNs, models[model].windowNs);
+        QCOMPARE(parallel[model].rawTransitions, std::uint64_t{ 100'000 });
+        QCOMPARE(parallel[model].reportedTransitions, sequential[model].reportedTransitions);
+        QCOMPARE(parallel[model].maxAddedLatencyNs, sequential[model].maxAddedLatencyNs);
+        QCOMPARE(parallel[model].meanAddedLatencyNs, sequential[model].meanAddedLatencyNs);
+        QVERIFY(parallel[model].suppressedTransitions > 0);
+    }
+}
+
+QTEST_GUILESS_MAIN(debounceSimulatorTests)
+
+#include "debounceSimulatorTests.moc"
@@ -0,0 +1,195 @@
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <unistd.h>
+
+#include <QtTest/QTest>
+
+#include "evdevInputBackend.h"
+#include "inputtester/core/inputEventQueue.h"
+#include "keyboardView.h"
+
+namespace
+{
+
+constexpr std::uint16_t g_keyA{ KEY_A };
+constexpr std::uint16_t g_keyRightCtrl{ KEY_RIGHTCTRL };
+
+input_event makeRecord(std::uint64_t timestampUs, std::uint16_t type, std::uint16_t code, std::int32_t value)
+{
+    input_event record{};
+    record.input_event_sec = static_cast<decltype(record.input_event_sec)>(timestampUs / 1'000'000);
+    record.input_event_usec = static_cast<decltype(record.input_event_usec)>(timestampUs % 1'000'000);
+    record.type = type;
+    record.code = code;
+    record.value = value;
+    return record;
+}
+
+std::vector<inputTester::inputEvent> drainAtLeast(inputTester::inputEventQueue& queue, std::size_t count)
+{
+    std::vector<inputTester::inputEvent> events{};
+    const auto deadline{ std::chrono::steady_clock::now() + std::chrono::seconds{ 5 } };
+    while (events.size() < count && std::chrono::steady_clock::now() < deadline)
+    {
+        queue.drain([&events](const inputTester::inputEvent& event) { events.push_back(event); });
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+    return events;
+}
+
+} // namespace
+
+class evdevInputBackendTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void readsRecordedEventsFromPipe();
+    void keyboardViewRegistersEvdevPresses();
+    void skipsTheFrameAfterAnOverrun();
+};
+
+void evdevInputBackendTests::readsRecordedEventsFromPipe()
+{
+    int fds[2]{ -1, -1 };
+    QVERIFY(::pipe2(fds, O_CLOEXEC) == 0);
+
+    LinuxKeymapParser::LinuxKeyMap keyMap{};
+    QVERIFY(LinuxKeymapParser::setScanMapping(keyMap, LinuxKeymapParser::ScanMapping{ g_keyRightCtrl, 0x1D, true }));
+
+    inputTester::inputEventQueue queue{};
+    inputTester::EvdevInputBackend backend{};
+    backend.addSource(fds[0]);
+    backend.setKeyMap(keyMap);
+    backend.setSink(&queue);
+    QString error{};
+    QVERIFY2(backend.start(nullptr, &error), qPrintable(error));
+
+    const std::vector<input_event> records{
+        makeRecord(1'000'001, EV_KEY, g_keyA, 1),         makeRecord(1'000'001, EV_SYN, SYN_REPORT, 0),
+        makeRecord(1'000'126, EV_REL, REL_X, 3),          makeRecord(1'000'126, EV_REL, REL_Y, -1),
+        makeRecord(1'000'126, EV_SYN, SYN_REPORT, 0),     makeRecord(1'000'251, EV_KEY, g_keyRightCtrl, 2),
+        makeRecord(1'000'251, EV_SYN, SYN_REPORT, 0),     makeRecord(1'000'376, EV_KEY, BTN_LEFT, 1),
+        makeRecord(1'000'376, EV_SYN, SYN_REPORT, 0),     makeRecord(1'000'501, EV_KEY, g_keyA, 0),
+        makeRecord(1'000'501, EV_SYN, SYN_REPORT, 0),
+    };
+    // Split one record across two writes, as a pipe may deliver it.
+    const auto* bytes{ reinterpret_cast<const char*>(records.data()) };
+    const auto totalBytes{ records.size() * sizeof(input_event) };
+    const auto splitAt{ sizeof(input_event) * 3 + sizeof(input_event) / 2 };
+    QCOMPARE(::write(fds[1], bytes, splitAt), static_cast<ssize_t>(splitAt));
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+    QCOMPARE(::write(fds[1], bytes + splitAt, totalBytes - splitAt), static_cast<ssize_t>(totalBytes - splitAt));
+
+    const auto events{ drainAtLeast(queue, 5) };
+    backend.stop();
+    ::close(fds[1]);
+
+    QCOMPARE(events.size(), std::size_t{ 5 });
+
+    QCOMPARE(events[0].kind, inputTester::eventKind::keyDown);
+    QCOMPARE(events[0].device, inputTester::deviceType::keyboard);
+    QCOMPARE(events[0].scanCode, std::uint32_t{ g_keyA });
+    QCOMPARE(events[0].deviceId, std::uint32_t{ 1 });
+
+    // Record times map onto the steady clock with one fixed offset, so their spacing is kept.
+    QCOMPARE(events[1].sourceTimestampNs - events[0].sourceTimestampNs, std::uint64_t{ 125'000 });
+    QCOMPARE(events[1].kind, inputTester::eventKind::motion);
+    QCOMPARE(events[1].device, inputTester::deviceType::mouse);
+
+    QCOMPARE(events[2].kind, inputTester::eventKind::keyDown);
+    QCOMPARE(events[2].repeatCount, std::uint16_t{ 1 });
+    QCOMPARE(events[2].scanCode, std::uint32_t{ 0x1D });
+    QVERIFY(events[2].isExtended);
+
+    QCOMPARE(events[3].device, inputTester::deviceType::mouse);
+    QCOMPARE(events[3].virtualKey, std::uint32_t{ 0x01 });
+
+    QCOMPARE(events[4].sourceTimestampNs - events[0].sourceTimestampNs, std::uint64_t{ 500'000 });
+    QVERIFY(events[4].receiveTimestampNs >= events[0].receiveTimestampNs);
+    QCOMPARE(events[4].kind, inputTester::eventKind::keyUp);
+}
+
+void evdevInputBackendTests::keyboardViewRegistersEvdevPresses()
+{
+    int fds[2]{ -1, -1 };
+    QVERIFY(::pipe2(fds, O_CLOEXEC) == 0);
+    inputTester::inputEventQueue queue{};
+    inputTester::EvdevInputBackend backend{};
+    backend.addSource(fds[0]);
+    backend.setKeyMap(LinuxKeymapParser::LinuxKeyMap{});
+    backend.setSink(&queue);
+    QString error{};
+    QVERIFY2(backend.start(nullptr, &error), qPrintable(error));
+
+    const std::vector<input_event> records{
+        makeRecord(1'000'001, EV_KEY, g_keyA, 1),
+        makeRecord(1'000'001, EV_KEY, KEY_S, 1),
+        makeRecord(1'000'001, EV_SYN, SYN_REPORT, 0),
+    };
+    const auto bytes{ static_cast<ssize_t>(records.size() * sizeof(input_event)) };
+    QCOMPARE(::write(fds[1], records.data(), static_cast<std::size_t>(bytes)), bytes);
+    const auto events{ drainAtLeast(queue, 2) };
+    backend.stop();
+    ::close(fds[1]);
+    QCOMPARE(events.size(), std::size_t{ 2 });
+
+    // A stored virtualKey preference must not blank the view: evdev events have no virtual key.
+    KeyboardView view{};
+    view.setKeyIdMode(KeyboardView::KeyIdMode::virtualKey);
+    view.setVirtualKeysAvailable(false);
+    view.setKeyIdMode(KeyboardView::KeyIdMode::virtualKey);
+    QCOMPARE(view.getKeyIdMode(), KeyboardView::KeyIdMode::scanCode);
+    for (const auto& event : events)
+    {
+        view.handleInputEvent(event);
+    }
+    QCOMPARE(view.getPressedKeyCount(), std::size_t{ 2 });
+}
+
+void evdevInputBackendTests::skipsTheFrameAfterAnOverrun()
+{
+    int fds[2]{ -1, -1 };
+    QVERIFY(::pipe2(fds, O_CLOEXEC) == 0);
+    inputTester::inputEventQueue queue{};
+    inputTester::EvdevInputBackend backend{};
+    backend.addSource(fds[0]);
+    backend.setKeyMap(LinuxKeymapParser::LinuxKeyMap{});
+    backend.setSink(&queue);
+    QString error{};
+    QVERIFY2(backend.start(nullptr, &error), qPrintable(error));
+
+    const std::vector<input_event> records{
+        makeRecord(1'000'001, EV_KEY, g_keyA, 1),         makeRecord(1'000'001, EV_SYN, SYN_REPORT, 0),
+        makeRecord(1'000'126, EV_REL, REL_X, 3),          makeRecord(1'000'126, EV_SYN, SYN_DROPPED, 0),
+        makeRecord(1'000'251, EV_KEY, KEY_S, 1),          makeRecord(1'000'251, EV_REL, REL_X, 2),
+        makeRecord(1'000'251, EV_SYN, SYN_REPORT, 0),     makeRecord(1'000'376, EV_KEY, KEY_D, 1),
+        makeRecord(1'000'376, EV_SYN, SYN_REPORT, 0),
+    };
+    const auto bytes{ static_cast<ssize_t>(records.size() * sizeof(input_event)) };
+    QCOMPARE(::write(fds[1], records.data(), static_cast<std::size_t>(bytes)), bytes);
+    const auto events{ drainAtLeast(queue, 3) };
+    backend.stop();
+    ::close(fds[1]);
+
+    // A pipe cannot be asked which keys are down, so the held A is released when the overrun ends; the lost
+    // frame's press of S and both motion samples never appear.
+    QCOMPARE(events.size(), std::size_t{ 3 });
+    QCOMPARE(events[0].kind, inputTester::eventKind::keyDown);
+    QCOMPARE(events[0].scanCode, std::uint32_t{ g_keyA });
+    QCOMPARE(events[1].kind, inputTester::eventKind::keyUp);
+    QCOMPARE(events[1].scanCode, std::uint32_t{ g_keyA });
+    QCOMPARE(events[1].sourceTimestampNs - events[0].sourceTimestampNs, std::uint64_t{ 250'000 });
+    QCOMPARE(events[2].kind, inputTester::eventKind::keyDown);
+    QCOMPARE(events[2].scanCode, std::uint32_t{ KEY_D });
+    QCOMPARE(backend.overrunCount(), std::uint64_t{ 1 });
+}
+
+QTEST_MAIN(evdevInputBackendTests)
+
+#include "evdevInputBackendTests.moc"
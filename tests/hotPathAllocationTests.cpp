@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <QKeyEvent>
+#include <QObject>
+#include <QtTest/QTest>
+
+#include "allocationTracker.h"
+#include "inputtester/core/inputEventMergeQueue.h"
+#include "inputtester/core/inputEventQueue.h"
+#include "inputtester/core/latencyTrace.h"
+#include "inputtester/platform/inputBackend.h"
+#include "keyboardView.h"
+
+// Every stage between backend and UI runs per event, so each must stay off the allocator once warmed up.
+namespace
+{
+
+constexpr std::size_t g_eventCount{ 20'000 };
+constexpr std::uint32_t g_keyCount{ 64 };
+
+inputTester::inputEvent makeKeyEvent(std::uint32_t seq)
+{
+    inputTester::inputEvent event{};
+    event.sourceTimestampNs = inputTester::nowTimestampNs();
+    event.receiveTimestampNs = event.sourceTimestampNs;
+    event.device = seq % 8 == 7 ? inputTester::deviceType::mouse : inputTester::deviceType::keyboard;
+    event.kind = event.device == inputTester::deviceType::mouse ? inputTester::eventKind::motion
+                 : seq % 2 == 0                                  ? inputTester::eventKind::keyDown
+                                                                 : inputTester::eventKind::keyUp;
+    event.virtualKey = 0x41 + (seq / 2) % g_keyCount;
+    event.scanCode = 0x10 + (seq / 2) % g_keyCount;
+    // Every 16th event needs the escaped multi-slot form.
+    event.deviceId = seq % 16 == 0 ? 1000 : 1;
+    return event;
+}
+
+std::uint64_t roundTrip(inputTester::inputEventQueue& queue)
+{
+    const allocationTracker::Region region{};
+    inputTester::inputEvent out{};
+    for (std::uint32_t seq = 0; seq < g_eventCount; ++seq)
+    {
+        queue.onInputEvent(makeKeyEvent(seq));
+        if (seq % 3 == 0)
+        {
+            queue.tryPop(out);
+        }
+        if (seq % 64 == 0)
+        {
+            queue.drain([](const inputTester::inputEvent&) {});
+        }
+    }
+    return region.allocations();
+}
+
+} // namespace
+
+class hotPathAllocationTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void queuePoliciesDoNotAllocate();
+    void reserveCommitDoesNotAllocate();
+    void mergeQueueDoesNotAllocate();
+    void latencyTraceDoesNotAllocate();
+    void keyboardViewDoesNotAllocate();
+    void keyboardViewRolloverDoesNotAllocate();
+    void linuxEventFilterDoesNotAllocate();
+};
+
+void hotPathAllocationTests::init()
+{
+    if (!allocationTracker::isActive())
+    {
+        QSKIP("allocation tracking is not available in this build");
+    }
+}
+
+void hotPathAllocationTests::queuePoliciesDoNotAllocate()
+{
+    for (const auto policy : { inputTester::overflowPolicy::dropNewest, inputTester::overflowPolicy::overwriteOldest,
+                               inputTester::overflowPolicy::coalesceMotion })
+    {
+        inputTester::inputEventQueue queue{ policy, 256 };
+        QCOMPARE(roundTrip(queue), std::uint64_t{ 0 });
+    }
+}
+
+void hotPathAllocationTests::reserveCommitDoesNotAllocate()
+{
+    inputTester::inputEventQueue queue{ inputTester::overflowPolicy::dropNewest, 256 };
+    const allocationTracker::Region region{};
+    for (std::uint32_t seq = 0; seq < g_eventCount; ++seq)
+    {
+        if (auto* slot{ queue.reserveEvent() })
+        {
+            *slot = makeKeyEvent(seq);
+            queue.commitEvent();
+        }
+        if (seq % 32 == 0)
+        {
+            queue.drain([](const inputTester::inputEvent&) {});
+        }
+    }
+    QCOMPARE(region.allocations(), std::uint64_t{ 0 });
+}
+
+void hotPathAllocationTests::mergeQueueDoesNotAllocate()
+{
+    inputTester::inputEventMergeQueue queue{ 4, inputTester::overflowPolicy::dropNewest, 256 };
+    // The first event claims this thread's lane.
+    queue.onInputEvent(makeKeyEvent(1));
+
+    const allocationTracker::Region region{};
+    for (std::uint32_t seq = 0; seq < g_eventCount; ++seq)
+    {
+        queue.onInputEvent(makeKeyEvent(seq));
+        if (seq % 64 == 0)
+        {
+            queue.drain([](const inputTester::inputEvent&) {});
+        }
+    }
+    QCOMPARE(region.allocations(), std::uint64_t{ 0 });
+}
+
+void hotPathAllocationTests::latencyTraceDoesNotAllocate()
+{
+    inputTester::inputEventMergeQueue queue{ 4, inputTester::overflowPolicy::dropNewest, 256 };
+    QVERIFY(queue.enableEnqueueStamps());
+    inputTester::latencyTrace trace{ 1024 };
+    queue.onInputEvent(makeKeyEvent(1));
+
+    const allocationTracker::Region region{};
+    for (std::uint32_t seq = 0; seq < g_eventCount; ++seq)
+    {
+        queue.onInputEvent(makeKeyEvent(seq));
+        if (seq % 64 == 0)
+        {
+            queue.drain(
+                [&queue, &trace](const inputTester::inputEvent& event)
+                {
+                    const auto sequence{ trace.begin(event, queue.lastEnqueueTimestampNs(),
+                                                     inputTester::nowTimestampNs()) };
+                    trace.stamp(sequence, inputTester::latencyStage::handled, inputTester::nowTimestampNs());
+                });
+            trace.stampPainted(inputTester::nowTimestampNs());
+        }
+    }
+    trace.summarize(inputTester::latencyStage::source, inputTester::latencyStage::painted);
+    QCOMPARE(region.allocations(), std::uint64_t{ 0 });
+}
+
+void hotPathAllocationTests::keyboardViewDoesNotAllocate()
+{
+    KeyboardView view{};
+    // Press every key once so first-seen bookkeeping is out of the way.
+    for (std::uint32_t seq = 0; seq < 2 * g_keyCount; ++seq)
+    {
+        view.handleInputEvent(makeKeyEvent(seq));
+    }
+
+    const allocationTracker::Region region{};
+    for (std::uint32_t seq = 0; seq < g_eventCount; ++seq)
+    {
+        view.handleInputEvent(makeKeyEvent(seq));
+    }
+    QCOMPARE(region.allocations(), std::uint64_t{ 0 });
+}
+
+void hotPathAllocationTests::keyboardViewRolloverDoesNotAllocate()
+{
+    KeyboardView view{};
+    view.setKeyIdMode(KeyboardView::KeyIdMode::scanCode);
+    auto event{ makeKeyEvent(0) };
+
+    std::size_t minHeld{ g_keyCount };
+    const allocationTracker::Region region{};
+    for (int round = 0; round < 100; ++round)
+    {
+        // Every key down at once, including extended ones, then all released.
+        for (const auto kind : { inputTester::eventKind::keyDown, inputTester::eventKind::keyUp })
+        {
+            event.kind = kind;
+            for (std::uint32_t scanCode = 1; scanCode <= g_keyCount; ++scanCode)
+            {
+                event.scanCode = scanCode;
+                event.isExtended = scanCode % 4 == 0;
+                view.handleInputEvent(event);
+            }
+            if (kind == inputTester::eventKind::keyDown)
+            {
+                minHeld = std::min(minHeld, view.getPressedKeyCount());
+            }
+        }
+    }
+    const auto allocations{ region.allocations() };
+    QCOMPARE(allocations, std::uint64_t{ 0 });
+    QCOMPARE(minHeld, std::size_t{ g_keyCount });
+    QCOMPARE(view.getPressedKeyCount(), std::size_t{ 0 });
+}
+
+void hotPathAllocationTests::linuxEventFilterDoesNotAllocate()
+{
+#if defined(__linux__)
+    QObject source{};
+    inputTester::inputEventQueue queue{ inputTester::overflowPolicy::dropNewest, 256 };
+    auto backend{ inputTester::createInputBackend() };
+    backend->setSink(&queue);
+    QString error{};
+    QVERIFY2(backend->start(&source, &error), qPrintable(error));
+    // eventFilter is public on QObject, so the filter can be driven without a running event loop.
+    auto* filter{ dynamic_cast<QObject*>(backend.get()) };
+    QVERIFY(filter != nullptr);
+
+    std::vector<std::unique_ptr<QKeyEvent>> events{};
+    for (std::uint32_t key = 0; key < g_keyCount; ++key)
+    {
+        const auto qtKey{ Qt::Key_A + static_cast<int>(key % 26) };
+        const QString text{ QChar{ static_cast<char16_t>(u'a' + key % 26) } };
+        events.push_back(std::make_unique<QKeyEvent>(QEvent::KeyPress, qtKey, Qt::NoModifier, 38 + key, 0, 0, text));
+        events.push_back(std::make_unique<QKeyEvent>(QEvent::KeyRelease, qtKey, Qt::NoModifier, 38 + key, 0, 0, text));
+    }
+
+    const allocationTracker::Region region{};
+    for (std::size_t round = 0; round < g_eventCount / events.size(); ++round)
+    {
+        for (const auto& event : events)
+        {
+            filter->eventFilter(&source, event.get());
+        }
+        queue.drain([](const inputTester::inputEvent&) {});
+    }
+    QCOMPARE(region.allocations(), std::uint64_t{ 0 });
+    backend->stop();
+#else
+    QSKIP("the Qt key-event backend is Linux only");
+#endif
+}
+
+QTEST_MAIN(hotPathAllocationTests)
+
+#include "hotPathAllocationTests.moc"
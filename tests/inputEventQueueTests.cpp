@@ -0,0 +1,219 @@
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <QtTest/QTest>
+
+#include "inputtester/core/inputEventMergeQueue.h"
+#include "inputtester/core/inputEventQueue.h"
+
+namespace
+{
+
+inputTester::inputEvent makeEvent(inputTester::eventKind kind, std::uint32_t scanCode)
+{
+    inputTester::inputEvent event{};
+    event.sourceTimestampNs = inputTester::nowTimestampNs();
+    event.receiveTimestampNs = event.sourceTimestampNs;
+    event.deviceId = 1;
+    event.device = kind == inputTester::eventKind::motion ? inputTester::deviceType::mouse
+                                                          : inputTester::deviceType::keyboard;
+    event.kind = kind;
+    event.scanCode = scanCode;
+    return event;
+}
+
+std::vector<std::uint32_t> drainScanCodes(inputTester::inputEventQueue& queue)
+{
+    std::vector<std::uint32_t> scanCodes{};
+    queue.drain([&scanCodes](const inputTester::inputEvent& event) { scanCodes.push_back(event.scanCode); });
+    return scanCodes;
+}
+
+class recordingSink final : public inputTester::inputEventSink
+{
+public:
+    void onInputEvent(const inputTester::inputEvent& event) override
+    {
+        scanCodes.push_back(event.scanCode);
+    }
+
+    std::vector<std::uint32_t> scanCodes;
+};
+
+} // namespace
+
+class inputEventQueueTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void reserveCommitFillsTheRing();
+    void reserveFallsBackForSinksWithoutSlots();
+    void deliversLastCoalescedMotionWithoutAnotherEvent();
+    void keysTakeFreedSlotsBehindAParkedMotion();
+    void coalescingKeepsProducerOrder();
+    void mergeQueueKeepsOneLanePerThread();
+};
+
+void inputEventQueueTests::reserveCommitFillsTheRing()
+{
+    inputTester::inputEventQueue queue{ inputTester::overflowPolicy::dropNewest, 4 };
+    for (std::uint32_t index = 0; index < 4; ++index)
+    {
+        auto* event{ queue.reserveEvent() };
+        QVERIFY(event != nullptr);
+        *event = makeEvent(inputTester::eventKind::keyDown, index);
+        queue.commitEvent();
+    }
+    QVERIFY(queue.reserveEvent() == nullptr);
+    QCOMPARE(queue.counters().dropped, std::uint64_t{ 1 });
+
+    QCOMPARE(drainScanCodes(queue), (std::vector<std::uint32_t>{ 0, 1, 2, 3 }));
+    QVERIFY(queue.reserveEvent() != nullptr);
+}
+
+void inputEventQueueTests::reserveFallsBackForSinksWithoutSlots()
+{
+    recordingSink sink{};
+    QVERIFY(sink.reserveEvent() == nullptr);
+    inputTester::inputEvent fallback{};
+    for (std::uint32_t index = 0; index < 3; ++index)
+    {
+        auto* event{ inputTester::reserveEvent(sink, fallback) };
+        QVERIFY(event == &fallback);
+        *event = makeEvent(inputTester::eventKind::keyDown, index);
+        inputTester::commitEvent(sink, fallback);
+    }
+    QCOMPARE(sink.scanCodes, (std::vector<std::uint32_t>{ 0, 1, 2 }));
+
+    // A queue's refusal is final: no fallback, and the drop is counted once.
+    inputTester::inputEventQueue queue{ inputTester::overflowPolicy::dropNewest, 4 };
+    for (std::uint32_t index = 0; index < 4; ++index)
+    {
+        queue.onInputEvent(makeEvent(inputTester::eventKind::keyDown, index));
+    }
+    QVERIFY(inputTester::reserveEvent(queue, fallback) == nullptr);
+    QCOMPARE(queue.counters().dropped, std::uint64_t{ 1 });
+}
+
+void inputEventQueueTests::deliversLastCoalescedMotionWithoutAnotherEvent()
+{
+    inputTester::inputEventQueue queue{ inputTester::overflowPolicy::coalesceMotion, 4 };
+    QCOMPARE(queue.capacity(), std::size_t{ 4 });
+    for (std::uint32_t index = 0; index < 7; ++index)
+    {
+        queue.onInputEvent(makeEvent(inputTester::eventKind::motion, index));
+    }
+
+    // Motions 4 and 5 were replaced while parked; 6 is the newest and must come out now.
+    QCOMPARE(drainScanCodes(queue), (std::vector<std::uint32_t>{ 0, 1, 2, 3, 6 }));
+    const auto counters{ queue.counters() };
+    QCOMPARE(counters.enqueued, std::uint64_t{ 5 });
+    QCOMPARE(counters.coalesced, std::uint64_t{ 2 });
+    QCOMPARE(counters.dropped, std::uint64_t{ 0 });
+
+    inputTester::inputEvent out{};
+    QVERIFY(!queue.tryPop(out));
+}
+
+void inputEventQueueTests::keysTakeFreedSlotsBehindAParkedMotion()
+{
+    inputTester::inputEventQueue queue{ inputTester::overflowPolicy::coalesceMotion, 4 };
+    for (std::uint32_t index = 0; index < 5; ++index)
+    {
+        queue.onInputEvent(makeEvent(inputTester::eventKind::motion, index));
+    }
+    inputTester::inputEvent out{};
+    QVERIFY(queue.tryPop(out));
+    QCOMPARE(out.scanCode, std::uint32_t{ 0 });
+
+    // Motion 4 is parked; the key gets the freed slot and the next one finds the ring full.
+    queue.onInputEvent(makeEvent(inputTester::eventKind::keyDown, 5));
+    queue.onInputEvent(makeEvent(inputTester::eventKind::keyUp, 6));
+    QCOMPARE(queue.counters().dropped, std::uint64_t{ 1 });
+
+    std::vector<std::uint32_t> scanCodes{};
+    while (queue.tryPop(out))
+    {
+        scanCodes.push_back(out.scanCode);
+    }
+    QCOMPARE(scanCodes, (std::vector<std::uint32_t>{ 1, 2, 3, 4, 5 }));
+}
+
+void inputEventQueueTests::coalescingKeepsProducerOrder()
+{
+    constexpr std::uint32_t eventCount{ 200'000 };
+    inputTester::inputEventQueue queue{ inputTester::overflowPolicy::coalesceMotion, 16 };
+    std::thread producer(
+        [&queue]()
+        {
+            for (std::uint32_t index = 0; index < eventCount; ++index)
+            {
+                const auto kind{ index % 4 == 1 ? inputTester::eventKind::keyDown : inputTester::eventKind::motion };
+                // The scan code field holds 12 bits; the timestamp carries the sequence.
+                auto event{ makeEvent(kind, index & 0xFFFU) };
+                event.receiveTimestampNs = event.sourceTimestampNs = index;
+                queue.onInputEvent(event);
+            }
+        });
+
+    std::uint64_t delivered{ 0 };
+    std::uint64_t previous{ 0 };
+    bool ordered{ true };
+    const auto check{ [&](const inputTester::inputEvent& event)
+                      {
+                          ordered = ordered && (delivered == 0 || event.sourceTimestampNs > previous);
+                          previous = event.sourceTimestampNs;
+                          ++delivered;
+                      } };
+    // The last event is a motion, which must arrive even though nothing is pushed after it.
+    const auto deadline{ std::chrono::steady_clock::now() + std::chrono::seconds{ 10 } };
+    while ((delivered == 0 || previous != eventCount - 1) && std::chrono::steady_clock::now() < deadline)
+    {
+        queue.drain(check);
+    }
+    producer.join();
+
+    QCOMPARE(previous, std::uint64_t{ eventCount - 1 });
+    QVERIFY(ordered);
+    const auto counters{ queue.counters() };
+    QCOMPARE(delivered, counters.enqueued);
+    QCOMPARE(counters.enqueued + counters.coalesced + counters.dropped, std::uint64_t{ eventCount });
+}
+
+void inputEventQueueTests::mergeQueueKeepsOneLanePerThread()
+{
+    // More queues than a thread could once remember; cycling through them must not claim further lanes.
+    std::array<std::unique_ptr<inputTester::inputEventMergeQueue>, 6> queues{};
+    for (auto& queue : queues)
+    {
+        queue = std::make_unique<inputTester::inputEventMergeQueue>(2, inputTester::overflowPolicy::dropNewest, 64);
+    }
+    for (std::uint32_t index = 0; index < 32; ++index)
+    {
+        queues[index % queues.size()]->onInputEvent(makeEvent(inputTester::eventKind::keyDown, index));
+    }
+
+    for (std::size_t queue = 0; queue < queues.size(); ++queue)
+    {
+        QCOMPARE(queues[queue]->producerCount(), std::size_t{ 1 });
+        QCOMPARE(queues[queue]->counters().dropped, std::uint64_t{ 0 });
+        std::vector<std::uint32_t> expected{};
+        for (auto index{ static_cast<std::uint32_t>(queue) }; index < 32; index += queues.size())
+        {
+            expected.push_back(index);
+        }
+        std::vector<std::uint32_t> scanCodes{};
+        queues[queue]->drain([&scanCodes](const inputTester::inputEvent& event)
+                             { scanCodes.push_back(event.scanCode); });
+        QCOMPARE(scanCodes, expected);
+    }
+}
+
+QTEST_GUILESS_MAIN(inputEventQueueTests)
+
+#include "inputEventQueueTests.moc"
@@ -0,0 +1,126 @@
+#include <cstdint>
+
+#include <QtTest/QTest>
+
+#include "inputtester/core/intervalHistogram.h"
+
+namespace
+{
+
+constexpr std::uint64_t g_period8kHzNs{ 125'000 };
+
+// Relative resolution of one sub-bucket.
+bool withinBucketError(std::uint64_t actual, std::uint64_t expected)
+{
+    const auto difference{ actual > expected ? actual - expected : expected - actual };
+    return difference * inputTester::intervalHistogram::subBucketCount <= expected;
+}
+
+} // namespace
+
+class intervalHistogramTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void bucketsCoverEveryValue();
+    void summarizesSteadyPolling();
+    void percentilesTrackTheDistribution();
+    void countsOutliersAroundTheMedian();
+    void resetClearsEverything();
+};
+
+void intervalHistogramTests::bucketsCoverEveryValue()
+{
+    using histogram = inputTester::intervalHistogram;
+    for (const std::uint64_t value : { 0ULL, 1ULL, 63ULL, 64ULL, 65ULL, 127ULL, 128ULL, 129ULL, 999'999ULL,
+                                       125'000ULL, 1ULL << 40, (1ULL << 41) - 1 })
+    {
+        const auto index{ histogram::bucketIndex(value) };
+        QVERIFY(index < histogram::bucketCount);
+        QVERIFY(histogram::bucketLowNs(index) <= value);
+        if (index + 1 < histogram::bucketCount)
+        {
+            QVERIFY(histogram::bucketLowNs(index + 1) > value);
+        }
+    }
+    QCOMPARE(histogram::bucketIndex(~0ULL), histogram::bucketCount - 1);
+}
+
+void intervalHistogramTests::summarizesSteadyPolling()
+{
+    inputTester::intervalHistogram histogram{};
+    for (int sample = 0; sample < 8'000; ++sample)
+    {
+        histogram.record(g_period8kHzNs);
+    }
+
+    const auto summary{ histogram.summarize() };
+    QCOMPARE(summary.count, std::uint64_t{ 8'000 });
+    QCOMPARE(qRound(summary.rateHz), 8'000);
+    QCOMPARE(summary.jitterNs, 0.0);
+    QCOMPARE(summary.p1Ns, g_period8kHzNs);
+    QCOMPARE(summary.p50Ns, g_period8kHzNs);
+    QCOMPARE(summary.p99Ns, g_period8kHzNs);
+    QCOMPARE(summary.outliers, std::uint64_t{ 0 });
+}
+
+void intervalHistogramTests::percentilesTrackTheDistribution()
+{
+    inputTester::intervalHistogram histogram{};
+    // 1, 2, ... 100 us.
+    for (std::uint64_t step = 1; step <= 100; ++step)
+    {
+        histogram.record(step * 1'000);
+    }
+
+    QCOMPARE(histogram.valueAtPercentile(0.0), std::uint64_t{ 1'000 });
+    QCOMPARE(histogram.valueAtPercentile(100.0), std::uint64_t{ 100'000 });
+    QVERIFY(withinBucketError(histogram.valueAtPercentile(50.0), 50'000));
+    QVERIFY(withinBucketError(histogram.valueAtPercentile(99.0), 99'000));
+
+    const auto summary{ histogram.summarize() };
+    QCOMPARE(summary.p50Ns, histogram.valueAtPercentile(50.0));
+    QCOMPARE(summary.p99Ns, histogram.valueAtPercentile(99.0));
+    QVERIFY(withinBucketError(summary.p1Ns, 1'000));
+    QCOMPARE(summary.meanNs, 50'500.0);
+    // Sample standard deviation of 1..100, in us.
+    QVERIFY(qAbs(summary.jitterNs - 29'011.49) < 1.0);
+}
+
+void intervalHistogramTests::countsOutliersAroundTheMedian()
+{
+    inputTester::intervalHistogram histogram{};
+    for (int sample = 0; sample < 1'000; ++sample)
+    {
+        histogram.record(g_period8kHzNs + static_cast<std::uint64_t>(sample % 7) * 100);
+    }
+    // A missed poll, a doubled report and a long stall.
+    histogram.record(3 * g_period8kHzNs);
+    histogram.record(g_period8kHzNs / 4);
+    histogram.record(50'000'000);
+
+    const auto summary{ histogram.summarize() };
+    QCOMPARE(summary.outliers, std::uint64_t{ 3 });
+    QCOMPARE(summary.maxNs, std::uint64_t{ 50'000'000 });
+    QCOMPARE(summary.minNs, g_period8kHzNs / 4);
+}
+
+void intervalHistogramTests::resetClearsEverything()
+{
+    inputTester::intervalHistogram histogram{};
+    histogram.record(10);
+    histogram.record(1'000'000);
+    histogram.reset();
+    QCOMPARE(histogram.count(), std::uint64_t{ 0 });
+    QCOMPARE(histogram.valueAtPercentile(50.0), std::uint64_t{ 0 });
+
+    histogram.record(g_period8kHzNs);
+    const auto summary{ histogram.summarize() };
+    QCOMPARE(summary.minNs, g_period8kHzNs);
+    QCOMPARE(summary.maxNs, g_period8kHzNs);
+}
+
+QTEST_GUILESS_MAIN(intervalHistogramTests)
+
+#include "intervalHistogramTests.moc"
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+#include <QApplication>
+#include <QDir>
+#include <QImage>
+#include <QRegion>
+
+#include "keyboardView.h"
+
+// KeyboardView paint cost, rendered offscreen into a QImage: full frames, and the small dirty region a single key
+// change invalidates, with the per-key sprite cache on and off.
+namespace
+{
+
+constexpr int g_viewWidth{ 1'400 };
+constexpr int g_viewHeight{ 480 };
+// About one 1u key at this size, in the middle of the board.
+constexpr int g_keyRegionSize{ 72 };
+
+struct benchLayout
+{
+    const char* geometry;
+    const char* mapping;
+};
+
+constexpr std::array<benchLayout, 2> g_layouts{ {
+    { "layouts/ansi_full/ansi_full_kle.json", "layouts/ansi_full/ansi_full_mapping.json" },
+    { "layouts/ergo-dox.json", "" },
+} };
+
+void loadView(KeyboardView& view, benchmark::State& state)
+{
+    const auto& layout{ g_layouts[static_cast<std::size_t>(state.range(0))] };
+    const QDir root{ QString::fromUtf8(INPUTTESTER_SOURCE_DIR) };
+    const auto mappingPath{ layout.mapping[0] != '\0' ? root.filePath(layout.mapping) : QString{} };
+    QString error{};
+    if (!view.loadLayoutFromFiles(root.filePath(layout.geometry), mappingPath, &error))
+    {
+        state.SkipWithError(error.toStdString().c_str());
+        return;
+    }
+    view.setSpriteCache(state.range(1) != 0);
+    view.resize(g_viewWidth, g_viewHeight);
+    state.SetLabel(layout.geometry);
+}
+
+// Presses every other key so the frame mixes visual states.
+void pressSomeKeys(KeyboardView& view)
+{
+    view.setKeyIdMode(KeyboardView::KeyIdMode::scanCode);
+    for (std::uint32_t scanCode = 1; scanCode < 0x60; scanCode += 2)
+    {
+        inputTester::inputEvent event{};
+        event.device = inputTester::deviceType::keyboard;
+        event.kind = inputTester::eventKind::keyDown;
+        event.scanCode = scanCode;
+        view.handleInputEvent(event);
+    }
+}
+
+} // namespace
+
+static void bmPaintFullFrame(benchmark::State& state)
+{
+    KeyboardView view{};
+    loadView(view, state);
+    pressSomeKeys(view);
+    QImage image{ view.size(), QImage::Format_ARGB32_Premultiplied };
+    // The first render builds the cache.
+    view.render(&image);
+
+    for (auto _ : state)
+    {
+        view.render(&image);
+        benchmark::DoNotOptimize(image.constBits());
+    }
+    state.counters["frames/sec"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                                      benchmark::Counter::kIsRate);
+}
+
+static void bmPaintKeyRegion(benchmark::State& state)
+{
+    KeyboardView view{};
+    loadView(view, state);
+    pressSomeKeys(view);
+    QImage image{ view.size(), QImage::Format_ARGB32_Premultiplied };
+    view.render(&image);
+    const QRegion keyRegion{ (g_viewWidth - g_keyRegionSize) / 2, (g_viewHeight - g_keyRegionSize) / 2,
+                             g_keyRegionSize, g_keyRegionSize };
+
+    for (auto _ : state)
+    {
+        view.render(&image, QPoint{}, keyRegion);
+        benchmark::DoNotOptimize(image.constBits());
+    }
+    state.counters["frames/sec"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                                      benchmark::Counter::kIsRate);
+}
+
+// Args: layout index (0 ansi_full, 1 ergo-dox), sprite cache (0 off, 1 on).
+BENCHMARK(bmPaintFullFrame)->ArgsProduct({ { 0, 1 }, { 0, 1 } })->Unit(benchmark::kMicrosecond);
+BENCHMARK(bmPaintKeyRegion)->ArgsProduct({ { 0, 1 }, { 0, 1 } })->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char** argv)
+{
+    // Paints into QImages only, so no display is needed.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app{ argc, argv };
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+#include <cstdint>
+
+#include <QObject>
+#include <QtTest/QTest>
+
+#include "keyboardView.h"
+
+namespace
+{
+
+constexpr std::uint64_t g_msNs{ 1'000'000 };
+constexpr std::uint32_t g_vkShift{ 0x10 };
+constexpr std::uint32_t g_vkReturn{ 0x0D };
+constexpr std::uint32_t g_scanLeftShift{ 0x2A };
+constexpr std::uint32_t g_scanRightShift{ 0x36 };
+constexpr std::uint32_t g_scanReturn{ 0x1C };
+
+inputTester::inputEvent makeKey(std::uint32_t virtualKey, std::uint32_t scanCode, bool isExtended, bool pressed,
+                                std::uint64_t timestampNs)
+{
+    inputTester::inputEvent event{};
+    event.sourceTimestampNs = timestampNs;
+    event.receiveTimestampNs = timestampNs;
+    event.device = inputTester::deviceType::keyboard;
+    event.kind = pressed ? inputTester::eventKind::keyDown : inputTester::eventKind::keyUp;
+    event.virtualKey = virtualKey;
+    event.scanCode = scanCode;
+    event.isExtended = isExtended;
+    return event;
+}
+
+} // namespace
+
+class keyboardViewTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sharedVirtualKeysDoNotReadAsChatter();
+    void chatterSurvivesIdModeChanges();
+};
+
+void keyboardViewTests::sharedVirtualKeysDoNotReadAsChatter()
+{
+    KeyboardView view{};
+    view.setKeyIdMode(KeyboardView::KeyIdMode::virtualKey);
+
+    // Left Shift -> right Shift, then Enter -> keypad Enter, each 1 ms apart: same VK, different keys.
+    view.handleInputEvent(makeKey(g_vkShift, g_scanLeftShift, false, true, 10 * g_msNs));
+    view.handleInputEvent(makeKey(g_vkShift, g_scanLeftShift, false, false, 20 * g_msNs));
+    view.handleInputEvent(makeKey(g_vkShift, g_scanRightShift, false, true, 21 * g_msNs));
+    view.handleInputEvent(makeKey(g_vkShift, g_scanRightShift, false, false, 30 * g_msNs));
+    view.handleInputEvent(makeKey(g_vkReturn, g_scanReturn, false, true, 40 * g_msNs));
+    view.handleInputEvent(makeKey(g_vkReturn, g_scanReturn, false, false, 50 * g_msNs));
+    view.handleInputEvent(makeKey(g_vkReturn, g_scanReturn, true, true, 51 * g_msNs));
+    QCOMPARE(view.getChatterDetector().totalBounces(), std::uint64_t{ 0 });
+
+    // A real re-press of the same key still counts.
+    view.handleInputEvent(makeKey(g_vkShift, g_scanLeftShift, false, true, 60 * g_msNs));
+    view.handleInputEvent(makeKey(g_vkShift, g_scanLeftShift, false, false, 70 * g_msNs));
+    view.handleInputEvent(makeKey(g_vkShift, g_scanLeftShift, false, true, 71 * g_msNs));
+    QCOMPARE(view.getChatterDetector().totalBounces(), std::uint64_t{ 1 });
+    QVERIFY(view.getChatterDetector().isChattering(g_scanLeftShift));
+}
+
+void keyboardViewTests::chatterSurvivesIdModeChanges()
+{
+    KeyboardView view{};
+    view.setKeyIdMode(KeyboardView::KeyIdMode::scanCode);
+    view.handleInputEvent(makeKey(g_vkShift, g_scanRightShift, false, true, 10 * g_msNs));
+    view.handleInputEvent(makeKey(g_vkShift, g_scanRightShift, false, false, 20 * g_msNs));
+    view.handleInputEvent(makeKey(g_vkShift, g_scanRightShift, false, true, 21 * g_msNs));
+    QCOMPARE(view.getChatterDetector().totalBounces(), std::uint64_t{ 1 });
+
+    view.setKeyIdMode(KeyboardView::KeyIdMode::virtualKey);
+    QCOMPARE(view.getChatterDetector().totalBounces(), std::uint64_t{ 1 });
+    QVERIFY(view.getChatterDetector().isChattering(g_scanRightShift));
+
+    // The key is still down; its release and a quick re-press in the new mode land on the same id.
+    view.handleInputEvent(makeKey(g_vkShift, g_scanRightShift, false, false, 30 * g_msNs));
+    view.handleInputEvent(makeKey(g_vkShift, g_scanRightShift, false, true, 31 * g_msNs));
+    QCOMPARE(view.getChatterDetector().stats(g_scanRightShift).bounces, std::uint32_t{ 2 });
+}
+
+QTEST_MAIN(keyboardViewTests)
+
+#include "keyboardViewTests.moc"
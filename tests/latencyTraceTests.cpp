@@ -0,0 +1,225 @@
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <QtTest/QTest>
+
+#include "inputtester/core/inputEventMergeQueue.h"
+#include "inputtester/core/inputEventQueue.h"
+#include "inputtester/core/latencyTrace.h"
+
+namespace
+{
+
+constexpr std::uint32_t g_eventsPerLane{ 200 };
+
+inputTester::inputEvent makeKeyEvent(std::uint32_t deviceId, std::uint32_t scanCode)
+{
+    inputTester::inputEvent event{};
+    event.sourceTimestampNs = inputTester::nowTimestampNs();
+    event.receiveTimestampNs = event.sourceTimestampNs;
+    event.deviceId = deviceId;
+    event.device = inputTester::deviceType::keyboard;
+    event.kind = inputTester::eventKind::keyDown;
+    event.scanCode = scanCode;
+    return event;
+}
+
+} // namespace
+
+class latencyTraceTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void summarizesStageIntervals();
+    void skipsRecordsMissingAStage();
+    void paintStampsEveryPendingRecord();
+    void keepsOnlyTheNewestRecords();
+    void queueDeliversEnqueueStamps();
+    void queueKeepsEnqueueStampsWhenFull();
+    void mergeQueueKeepsEnqueueStampsWithTheirEvents();
+};
+
+void latencyTraceTests::summarizesStageIntervals()
+{
+    inputTester::latencyTrace trace{ 128 };
+    // Receive 10, 20, ... 1000 ns after the source stamp.
+    for (std::uint64_t index = 100; index >= 1; --index)
+    {
+        inputTester::inputEvent event{};
+        event.sourceTimestampNs = 1'000;
+        event.receiveTimestampNs = 1'000 + index * 10;
+        trace.begin(event, 0, 0);
+    }
+
+    const auto summary{ trace.summarize(inputTester::latencyStage::source, inputTester::latencyStage::receive) };
+    QCOMPARE(summary.count, std::size_t{ 100 });
+    QCOMPARE(summary.p50Ns, std::uint64_t{ 500 });
+    QCOMPARE(summary.p99Ns, std::uint64_t{ 990 });
+    QCOMPARE(summary.maxNs, std::uint64_t{ 1'000 });
+}
+
+void latencyTraceTests::skipsRecordsMissingAStage()
+{
+    inputTester::latencyTrace trace{ 16 };
+    inputTester::inputEvent event{};
+    event.sourceTimestampNs = 100;
+    event.receiveTimestampNs = 100;
+    const auto stamped{ trace.begin(event, 150, 200) };
+    trace.begin(event, 0, 300);
+    trace.stamp(stamped, inputTester::latencyStage::handled, 260);
+
+    const auto queued{ trace.summarize(inputTester::latencyStage::enqueue, inputTester::latencyStage::dequeue) };
+    QCOMPARE(queued.count, std::size_t{ 1 });
+    QCOMPARE(queued.maxNs, std::uint64_t{ 50 });
+    const auto handled{ trace.summarize(inputTester::latencyStage::dequeue, inputTester::latencyStage::handled) };
+    QCOMPARE(handled.count, std::size_t{ 1 });
+    QCOMPARE(handled.p50Ns, std::uint64_t{ 60 });
+}
+
+void latencyTraceTests::paintStampsEveryPendingRecord()
+{
+    inputTester::latencyTrace trace{ 16 };
+    const inputTester::inputEvent event{};
+    trace.begin(event, 0, 10);
+    trace.begin(event, 0, 20);
+    trace.stampPainted(100);
+    trace.begin(event, 0, 30);
+    trace.stampPainted(200);
+    trace.stampPainted(300);
+
+    std::vector<std::uint64_t> painted{};
+    trace.forEachRecord([&painted](std::uint64_t, const inputTester::latencyTrace::stageStamps& stamps)
+                        { painted.push_back(stamps[static_cast<std::size_t>(inputTester::latencyStage::painted)]); });
+    QCOMPARE(painted, (std::vector<std::uint64_t>{ 100, 100, 200 }));
+}
+
+void latencyTraceTests::keepsOnlyTheNewestRecords()
+{
+    inputTester::latencyTrace trace{ 4 };
+    QCOMPARE(trace.capacity(), std::size_t{ 4 });
+    const inputTester::inputEvent event{};
+    for (std::uint64_t index = 0; index < 10; ++index)
+    {
+        trace.begin(event, 0, index + 1);
+    }
+    // Sequence 2 was overwritten by sequence 6, which must keep its own stamps.
+    trace.stamp(2, inputTester::latencyStage::handled, 99);
+
+    std::vector<std::uint64_t> sequences{};
+    trace.forEachRecord(
+        [&sequences](std::uint64_t sequence, const inputTester::latencyTrace::stageStamps& stamps)
+        {
+            sequences.push_back(sequence);
+            QCOMPARE(stamps[static_cast<std::size_t>(inputTester::latencyStage::dequeue)], sequence + 1);
+            QCOMPARE(stamps[static_cast<std::size_t>(inputTester::latencyStage::handled)], std::uint64_t{ 0 });
+        });
+    QCOMPARE(sequences, (std::vector<std::uint64_t>{ 6, 7, 8, 9 }));
+    QCOMPARE(trace.recorded(), std::uint64_t{ 10 });
+}
+
+void latencyTraceTests::queueDeliversEnqueueStamps()
+{
+    inputTester::inputEventQueue evicting{ inputTester::overflowPolicy::overwriteOldest, 64 };
+    QVERIFY(!evicting.enableEnqueueStamps());
+
+    inputTester::inputEventQueue queue{ inputTester::overflowPolicy::dropNewest, 64 };
+    QVERIFY(queue.enableEnqueueStamps());
+    std::vector<std::uint64_t> pushedAfter{};
+    for (std::uint32_t index = 0; index < 40; ++index)
+    {
+        // Every 8th event takes the escaped multi-slot form.
+        queue.onInputEvent(makeKeyEvent(index % 8 == 0 ? 1000 : 1, index));
+        pushedAfter.push_back(inputTester::nowTimestampNs());
+    }
+
+    std::size_t delivered{ 0 };
+    queue.drain(
+        [&](const inputTester::inputEvent& event)
+        {
+            const auto enqueueNs{ queue.lastEnqueueTimestampNs() };
+            QVERIFY(enqueueNs >= event.receiveTimestampNs);
+            QVERIFY(enqueueNs <= pushedAfter[event.scanCode]);
+            ++delivered;
+        });
+    QCOMPARE(delivered, std::size_t{ 40 });
+}
+
+void latencyTraceTests::queueKeepsEnqueueStampsWhenFull()
+{
+    inputTester::inputEventQueue queue{ inputTester::overflowPolicy::dropNewest, 64 };
+    QVERIFY(queue.enableEnqueueStamps());
+    std::vector<std::uint64_t> pushedAfter{};
+    std::size_t delivered{ 0 };
+    bool paired{ true };
+    const auto check{ [&](const inputTester::inputEvent& event)
+                      {
+                          const auto enqueueNs{ queue.lastEnqueueTimestampNs() };
+                          paired = paired && enqueueNs >= event.receiveTimestampNs &&
+                                   enqueueNs <= pushedAfter[event.scanCode];
+                          ++delivered;
+                      } };
+
+    // Three rounds of twice the ring's worth, so most pushes find it full and drop. The first round fills every
+    // slot with a one-slot event; later rounds escape every 5th event.
+    std::uint32_t index{ 0 };
+    for (int round = 0; round < 3; ++round)
+    {
+        for (std::uint32_t pushed = 0; pushed < 128; ++pushed, ++index)
+        {
+            queue.onInputEvent(makeKeyEvent(round > 0 && index % 5 == 0 ? 1000 : 1, index));
+            pushedAfter.push_back(inputTester::nowTimestampNs());
+        }
+        queue.drain(check, 16);
+    }
+    queue.drain(check);
+
+    QVERIFY(paired);
+    QVERIFY(queue.counters().dropped > 0);
+    QCOMPARE(delivered, static_cast<std::size_t>(queue.counters().enqueued));
+}
+
+void latencyTraceTests::mergeQueueKeepsEnqueueStampsWithTheirEvents()
+{
+    constexpr std::size_t laneCount{ 2 };
+    inputTester::inputEventMergeQueue queue{ laneCount, inputTester::overflowPolicy::dropNewest, 512 };
+    QVERIFY(queue.enableEnqueueStamps());
+
+    std::array<std::vector<std::uint64_t>, laneCount> pushedAfter{};
+    std::vector<std::thread> producers{};
+    for (std::size_t lane = 0; lane < laneCount; ++lane)
+    {
+        producers.emplace_back(
+            [&queue, &pushedAfter, lane]()
+            {
+                for (std::uint32_t index = 0; index < g_eventsPerLane; ++index)
+                {
+                    queue.onInputEvent(makeKeyEvent(static_cast<std::uint32_t>(lane), index));
+                    pushedAfter[lane].push_back(inputTester::nowTimestampNs());
+                }
+            });
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    std::size_t delivered{ 0 };
+    bool paired{ true };
+    queue.drain(
+        [&](const inputTester::inputEvent& event)
+        {
+            const auto enqueueNs{ queue.lastEnqueueTimestampNs() };
+            paired = paired && enqueueNs >= event.receiveTimestampNs &&
+                     enqueueNs <= pushedAfter[event.deviceId][event.scanCode];
+            ++delivered;
+        });
+    QCOMPARE(delivered, laneCount * g_eventsPerLane);
+    QVERIFY(paired);
+}
+
+QTEST_GUILESS_MAIN(latencyTraceTests)
+
+#include "latencyTraceTests.moc"
@@ -0,0 +1,108 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <QKeyEvent>
+#include <QString>
+#include <QtTest/QTest>
+
+#include "allocationTracker.h"
+#include "linuxKeyTranslation.h"
+#include "linuxKeymapParser.h"
+
+namespace
+{
+
+constexpr std::uint32_t g_x11KeycodeOffset{ 8 };
+constexpr std::size_t g_burstRounds{ 256 };
+
+struct keySpec
+{
+    int qtKey{};
+    Qt::KeyboardModifiers modifiers{};
+    std::uint32_t linuxScanCode{};
+    QString text{};
+};
+
+std::vector<std::unique_ptr<QKeyEvent>> makeKeyBurst()
+{
+    const std::vector<keySpec> keys{
+        { Qt::Key_A, Qt::NoModifier, 30, QStringLiteral("a") },
+        { Qt::Key_1, Qt::KeypadModifier, 79, QStringLiteral("1") },
+        { Qt::Key_Return, Qt::NoModifier, 28, QStringLiteral("\r") },
+        { Qt::Key_Backspace, Qt::NoModifier, 14, QStringLiteral("\b") },
+        { Qt::Key_Control, Qt::NoModifier, 97, QString{} },
+        { Qt::Key_unknown, Qt::NoModifier, 0, QString::fromUtf8("\xF0\x9F\x98\x80") },
+    };
+    std::vector<std::unique_ptr<QKeyEvent>> events{};
+    for (std::size_t round = 0; round < g_burstRounds; ++round)
+    {
+        for (const auto& key : keys)
+        {
+            const auto nativeScanCode{ key.linuxScanCode + g_x11KeycodeOffset };
+            const bool autoRepeat{ round % 4 == 3 };
+            events.push_back(std::make_unique<QKeyEvent>(QEvent::KeyPress, key.qtKey, key.modifiers, nativeScanCode,
+                                                         0, 0, key.text, autoRepeat));
+            events.push_back(std::make_unique<QKeyEvent>(QEvent::KeyRelease, key.qtKey, key.modifiers,
+                                                         nativeScanCode, 0, 0, key.text));
+        }
+    }
+    return events;
+}
+
+inputTester::eventKind kindOf(const QKeyEvent& event)
+{
+    return event.type() == QEvent::KeyPress ? inputTester::eventKind::keyDown : inputTester::eventKind::keyUp;
+}
+
+} // namespace
+
+class linuxKeyTranslationTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void firstCodepointDecodesUtf16();
+    void translatesKeyBurstWithoutAllocating();
+};
+
+void linuxKeyTranslationTests::firstCodepointDecodesUtf16()
+{
+    QCOMPARE(inputTester::firstCodepoint(QString{}), U'\0');
+    QCOMPARE(inputTester::firstCodepoint(QStringLiteral("ab")), U'a');
+    QCOMPARE(inputTester::firstCodepoint(QString::fromUtf8("\xC3\xA9")), U'\u00E9');
+    QCOMPARE(inputTester::firstCodepoint(QString::fromUtf8("\xF0\x9F\x98\x80")), U'\U0001F600');
+
+    const QChar loneHigh{ static_cast<char16_t>(0xD83D) };
+    QCOMPARE(inputTester::firstCodepoint(QString{ loneHigh }), U'\uFFFD');
+}
+
+void linuxKeyTranslationTests::translatesKeyBurstWithoutAllocating()
+{
+    if (!allocationTracker::isActive())
+    {
+        QSKIP("allocation tracking is not available in this build");
+    }
+    const auto& map{ LinuxKeymapParser::bundledLinuxKeyMap() };
+    const auto events{ makeKeyBurst() };
+    std::vector<inputTester::inputEvent> translated(events.size());
+
+    const allocationTracker::Region region{};
+    for (std::size_t index = 0; index < events.size(); ++index)
+    {
+        inputTester::translateKeyEvent(map, events[index].get(), kindOf(*events[index]), translated[index]);
+    }
+    QCOMPARE(region.allocations(), std::uint64_t{ 0 });
+
+    // Keypad 1 press, right Ctrl release and the emoji press from the first round.
+    QCOMPARE(translated[2].virtualKey, std::uint32_t{ 97 });
+    QCOMPARE(translated[2].text, U'1');
+    QCOMPARE(translated[9].scanCode, std::uint32_t{ 29 });
+    QVERIFY(translated[9].isExtended);
+    QCOMPARE(translated[10].text, U'\U0001F600');
+}
+
+QTEST_GUILESS_MAIN(linuxKeyTranslationTests)
+
+#include "linuxKeyTranslationTests.moc"
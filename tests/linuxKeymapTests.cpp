@@ -1,3 +1,5 @@
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 #include <QDir>
@@ -31,6 +33,8 @@ class linuxKeymapTests final : public QObject
 private slots:
     void linuxKeymapJsonIsValid();
     void linuxKeymapJsonRejectsInvalid();
+    void bundledKeyMapMatchesJson();
+    void keypadKeysFallBackToMainBlock();
 };
 
 void linuxKeymapTests::linuxKeymapJsonIsValid()
@@ -62,6 +66,39 @@ void linuxKeymapTests::linuxKeymapJsonRejectsInvalid()
     QVERIFY(containsError(errors, "linuxScanToWinScan"));
 }
 
+void linuxKeymapTests::bundledKeyMapMatchesJson()
+{
+    const QString root{ QString::fromUtf8(INPUTTESTER_SOURCE_DIR) };
+    QString error{};
+    LinuxKeymapParser::LinuxKeyMap parsed{};
+    QVERIFY2(LinuxKeymapParser::loadLinuxKeyMap(QDir{ root }.filePath("resources/linux_keymap.json"), &parsed, &error),
+             qPrintable(error));
+
+    const auto& bundled{ LinuxKeymapParser::bundledLinuxKeyMap() };
+    QCOMPARE(bundled.nativeScanCodeOffset, parsed.nativeScanCodeOffset);
+    QVERIFY(bundled.qtKeyToVirtualKey == parsed.qtKeyToVirtualKey);
+    for (std::size_t code = 0; code < bundled.linuxScanToWinScan.size(); ++code)
+    {
+        QCOMPARE(bundled.linuxScanToWinScan[code].scanCode, parsed.linuxScanToWinScan[code].scanCode);
+        QCOMPARE(bundled.linuxScanToWinScan[code].isExtended, parsed.linuxScanToWinScan[code].isExtended);
+    }
+}
+
+void linuxKeymapTests::keypadKeysFallBackToMainBlock()
+{
+    const auto& map{ LinuxKeymapParser::bundledLinuxKeyMap() };
+    QCOMPARE(LinuxKeymapParser::lookupVirtualKey(map, Qt::Key_1, true), std::uint32_t{ 97 });
+    QCOMPARE(LinuxKeymapParser::lookupVirtualKey(map, Qt::Key_1, false), std::uint32_t{ 49 });
+    QCOMPARE(LinuxKeymapParser::lookupVirtualKey(map, Qt::Key_Home, true), std::uint32_t{ 36 });
+    QCOMPARE(LinuxKeymapParser::lookupVirtualKey(map, Qt::Key_unknown, false), std::uint32_t{ 0 });
+
+    const auto rightCtrl{ LinuxKeymapParser::translateLinuxScanCode(map, 97) };
+    QCOMPARE(rightCtrl.scanCode, std::uint32_t{ 29 });
+    QVERIFY(rightCtrl.isExtended);
+    QCOMPARE(LinuxKeymapParser::translateLinuxScanCode(map, 30).scanCode, std::uint32_t{ 30 });
+    QCOMPARE(LinuxKeymapParser::translateLinuxScanCode(map, 0x10000).scanCode, std::uint32_t{ 0x10000 });
+}
+
 QTEST_MAIN(linuxKeymapTests)
 
 #include "linuxKeymapTests.moc"
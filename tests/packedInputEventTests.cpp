@@ -0,0 +1,139 @@
+#include <array>
+#include <cstdint>
+
+#include <QtTest/QTest>
+
+#include "inputtester/core/inputEventQueue.h"
+#include "inputtester/core/packedInputEvent.h"
+
+namespace
+{
+
+constexpr std::uint64_t g_epochNs{ 1'000'000 };
+
+inputTester::inputEvent makeTextKeyEvent()
+{
+    inputTester::inputEvent event{};
+    event.sourceTimestampNs = g_epochNs + 123'456'789;
+    event.receiveTimestampNs = event.sourceTimestampNs + 250'000;
+    event.deviceId = 7;
+    event.device = inputTester::deviceType::keyboard;
+    event.kind = inputTester::eventKind::keyDown;
+    event.virtualKey = 0x41;
+    event.scanCode = 0x1E;
+    event.repeatCount = 1;
+    event.isExtended = true;
+    event.isTextEvent = true;
+    event.text = U'\U0001F600';
+    return event;
+}
+
+bool sameEvent(const inputTester::inputEvent& lhs, const inputTester::inputEvent& rhs)
+{
+    return lhs.sourceTimestampNs == rhs.sourceTimestampNs && lhs.receiveTimestampNs == rhs.receiveTimestampNs &&
+           lhs.deviceId == rhs.deviceId && lhs.device == rhs.device && lhs.kind == rhs.kind &&
+           lhs.virtualKey == rhs.virtualKey && lhs.scanCode == rhs.scanCode && lhs.repeatCount == rhs.repeatCount &&
+           lhs.isExtended == rhs.isExtended && lhs.isTextEvent == rhs.isTextEvent && lhs.text == rhs.text;
+}
+
+} // namespace
+
+class packedInputEventTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void packsTextKeyEventIntoOneSlot();
+    void escapesEventsThatDoNotFit();
+    void discardsTruncatedEscapedEvent();
+    void queueRoundTripsMixedEvents();
+};
+
+void packedInputEventTests::packsTextKeyEventIntoOneSlot()
+{
+    inputTester::packedEventEncoder encoder{ g_epochNs };
+    inputTester::packedEventDecoder decoder{ g_epochNs };
+    const auto event{ makeTextKeyEvent() };
+
+    inputTester::packedInputEvent slot{};
+    QVERIFY(encoder.tryPack(event, slot));
+    inputTester::inputEvent decoded{};
+    QVERIFY(decoder.feed(slot, decoded));
+    QVERIFY(sameEvent(event, decoded));
+}
+
+void packedInputEventTests::escapesEventsThatDoNotFit()
+{
+    inputTester::packedEventEncoder encoder{ g_epochNs };
+    inputTester::packedEventDecoder decoder{ g_epochNs };
+    auto event{ makeTextKeyEvent() };
+    event.sourceTimestampNs = g_epochNs - 1;
+    event.virtualKey = 0x12345;
+    event.deviceId = 1000;
+
+    inputTester::packedInputEvent slot{};
+    QVERIFY(!encoder.tryPack(event, slot));
+
+    std::array<inputTester::packedInputEvent, inputTester::escapedSlotCount> escapedSlots{};
+    encoder.packEscaped(event, escapedSlots);
+    inputTester::inputEvent decoded{};
+    for (std::size_t part = 0; part + 1 < escapedSlots.size(); ++part)
+    {
+        QVERIFY(!decoder.feed(escapedSlots[part], decoded));
+    }
+    QVERIFY(decoder.feed(escapedSlots.back(), decoded));
+    QVERIFY(sameEvent(event, decoded));
+}
+
+void packedInputEventTests::discardsTruncatedEscapedEvent()
+{
+    inputTester::packedEventEncoder encoder{ g_epochNs };
+    inputTester::packedEventDecoder decoder{ g_epochNs };
+    auto escaped{ makeTextKeyEvent() };
+    escaped.scanCode = 0x10000;
+
+    std::array<inputTester::packedInputEvent, inputTester::escapedSlotCount> escapedSlots{};
+    encoder.packEscaped(escaped, escapedSlots);
+    inputTester::inputEvent decoded{};
+    // The first part was evicted: the remaining parts must not produce an event.
+    for (std::size_t part = 1; part < escapedSlots.size(); ++part)
+    {
+        QVERIFY(!decoder.feed(escapedSlots[part], decoded));
+    }
+
+    const auto event{ makeTextKeyEvent() };
+    inputTester::packedInputEvent slot{};
+    QVERIFY(encoder.tryPack(event, slot));
+    QVERIFY(decoder.feed(slot, decoded));
+    QVERIFY(sameEvent(event, decoded));
+}
+
+void packedInputEventTests::queueRoundTripsMixedEvents()
+{
+    inputTester::inputEventQueue queue{ inputTester::overflowPolicy::dropNewest, 8 };
+    for (std::uint32_t round = 0; round < 16; ++round)
+    {
+        for (std::uint32_t index = 0; index < 2; ++index)
+        {
+            auto event{ makeTextKeyEvent() };
+            event.sourceTimestampNs = inputTester::nowTimestampNs();
+            event.receiveTimestampNs = event.sourceTimestampNs;
+            event.scanCode = index;
+            event.deviceId = (round + index) % 2 == 0 ? 1 : 1000;
+            queue.onInputEvent(event);
+        }
+
+        std::uint32_t expected{ 0 };
+        queue.drain([&](const inputTester::inputEvent& event) {
+            QCOMPARE(event.scanCode, expected);
+            QCOMPARE(event.deviceId, (round + expected) % 2 == 0 ? 1U : 1000U);
+            ++expected;
+        });
+        QCOMPARE(expected, 2U);
+    }
+    QCOMPARE(queue.counters().dropped, std::uint64_t{ 0 });
+}
+
+QTEST_MAIN(packedInputEventTests)
+
+#include "packedInputEventTests.moc"
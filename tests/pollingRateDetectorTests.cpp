@@ -0,0 +1,147 @@
+#include <cstdint>
+
+#include <QtTest/QTest>
+
+#include "inputtester/core/pollingRateDetector.h"
+
+namespace
+{
+
+constexpr std::uint64_t g_startNs{ 1'000'000'000 };
+
+// Deterministic timestamp jitter in [-amplitudeNs, amplitudeNs].
+std::int64_t jitter(std::uint64_t index, std::int64_t amplitudeNs)
+{
+    const auto hash{ (index * 2'654'435'761ULL) % 2'001ULL };
+    return (static_cast<std::int64_t>(hash) - 1'000) * amplitudeNs / 1'000;
+}
+
+void recordStream(inputTester::pollingRateDetector& detector, std::uint64_t periodNs, std::uint64_t reports,
+                  std::int64_t jitterNs)
+{
+    for (std::uint64_t report = 0; report < reports; ++report)
+    {
+        const auto timestampNs{ static_cast<std::int64_t>(g_startNs + report * periodNs) + jitter(report, jitterNs) };
+        detector.record(static_cast<std::uint64_t>(timestampNs));
+    }
+}
+
+} // namespace
+
+class pollingRateDetectorTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void detectsContinuousStreams();
+    void detectsSparseKeyPresses();
+    void countsMissedPolls();
+    void needsEnoughIntervals();
+    void ignoresUnalignedTimestamps();
+    void resetClearsEverything();
+};
+
+void pollingRateDetectorTests::detectsContinuousStreams()
+{
+    for (const std::uint32_t rateHz : inputTester::pollingRateDetector::candidateRatesHz)
+    {
+        inputTester::pollingRateDetector detector{};
+        const auto periodNs{ 1'000'000'000ULL / rateHz };
+        recordStream(detector, periodNs, 1'000, static_cast<std::int64_t>(periodNs / 20));
+
+        const auto estimate{ detector.estimate() };
+        QCOMPARE(estimate.rateHz, rateHz);
+        QCOMPARE(estimate.periodNs, periodNs);
+        QVERIFY(estimate.confidence > 0.9);
+        QCOMPARE(estimate.missedPolls, std::uint64_t{ 0 });
+    }
+}
+
+void pollingRateDetectorTests::detectsSparseKeyPresses()
+{
+    // Key presses land on arbitrary 1 ms polls, 1 to 61 polls apart.
+    inputTester::pollingRateDetector detector{};
+    std::uint64_t timestampNs{ g_startNs };
+    for (std::uint64_t press = 0; press < 200; ++press)
+    {
+        timestampNs += (1 + (press * 37) % 61) * 1'000'000;
+        detector.record(timestampNs + static_cast<std::uint64_t>(jitter(press, 20'000) + 20'000));
+    }
+
+    const auto estimate{ detector.estimate() };
+    QCOMPARE(estimate.rateHz, 1'000U);
+    QVERIFY(estimate.confidence > 0.5);
+}
+
+void pollingRateDetectorTests::countsMissedPolls()
+{
+    inputTester::pollingRateDetector detector{};
+    std::uint64_t timestampNs{ g_startNs };
+    for (int report = 0; report < 200; ++report)
+    {
+        timestampNs += 1'000'000;
+        detector.record(timestampNs);
+    }
+    // Two polls missed, a repeated timestamp and then the stream resumes.
+    timestampNs += 3'000'000;
+    detector.record(timestampNs);
+    detector.record(timestampNs);
+    for (int report = 0; report < 10; ++report)
+    {
+        timestampNs += 1'000'000;
+        detector.record(timestampNs);
+    }
+    // A pause between bursts is not a gap.
+    timestampNs += 500'000'000;
+    detector.record(timestampNs);
+
+    const auto estimate{ detector.estimate() };
+    QCOMPARE(estimate.rateHz, 1'000U);
+    QCOMPARE(estimate.gaps, std::uint64_t{ 1 });
+    QCOMPARE(estimate.missedPolls, std::uint64_t{ 2 });
+    QCOMPARE(estimate.intervals, std::uint64_t{ 210 });
+}
+
+void pollingRateDetectorTests::needsEnoughIntervals()
+{
+    inputTester::pollingRateDetector detector{};
+    std::uint64_t timestampNs{ g_startNs };
+    for (int report = 0; report < 64; ++report)
+    {
+        QCOMPARE(detector.estimate().rateHz, detector.estimate().intervals < 16 ? 0U : 1'000U);
+        timestampNs += 1'000'000;
+        detector.record(timestampNs);
+    }
+    QCOMPARE(detector.estimate().intervals, std::uint64_t{ 63 });
+}
+
+void pollingRateDetectorTests::ignoresUnalignedTimestamps()
+{
+    // Intervals drawn from a continuous range match no poll period.
+    inputTester::pollingRateDetector detector{};
+    std::uint64_t timestampNs{ g_startNs };
+    for (std::uint64_t event = 0; event < 500; ++event)
+    {
+        timestampNs += 10'000'000 + (event * 7'919'113) % 40'000'000;
+        detector.record(timestampNs);
+    }
+    QCOMPARE(detector.estimate().rateHz, 0U);
+}
+
+void pollingRateDetectorTests::resetClearsEverything()
+{
+    inputTester::pollingRateDetector detector{};
+    recordStream(detector, 125'000, 1'000, 0);
+    detector.reset();
+
+    const auto cleared{ detector.estimate() };
+    QCOMPARE(cleared.rateHz, 0U);
+    QCOMPARE(cleared.intervals, std::uint64_t{ 0 });
+
+    recordStream(detector, 8'000'000, 100, 0);
+    QCOMPARE(detector.estimate().rateHz, 125U);
+}
+
+QTEST_GUILESS_MAIN(pollingRateDetectorTests)
+
+#include "pollingRateDetectorTests.moc"
@@ -1,17 +1,25 @@
 #include <benchmark/benchmark.h>
 
+#include "allocationTracker.h"
 #include "spscRingBufferAdapter.h"
 
 #include "inputtester/core/inputEvent.h"
+#include "inputtester/core/inputEventMergeQueue.h"
+#include "inputtester/core/inputEventQueue.h"
+#include "inputtester/core/intervalHistogram.h"
+#include "inputtester/core/packedInputEvent.h"
 #include "inputtester/core/spscRingBuffer.h"
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <span>
 #include <stdexcept>
 #include <thread>
 #include <vector>
@@ -20,6 +28,7 @@
 #error "tests/spscBench.cpp is intended to run on Linux only."
 #endif
 
+#include <poll.h>
 #include <pthread.h>
 #include <sched.h>
 
@@ -62,11 +71,47 @@ static void pinThread(int cpu)
     }
 }
 
+// Expects sortedAgesNs in ascending order.
+static std::uint64_t ageAtPercentile(const std::vector<std::uint64_t>& sortedAgesNs, double p)
+{
+    if (sortedAgesNs.empty())
+    {
+        return 0;
+    }
+    const auto idx = static_cast<std::size_t>((p / 100.0) * (static_cast<double>(sortedAgesNs.size() - 1)));
+    return sortedAgesNs[idx];
+}
+
+// Heap allocations per event on the measured thread; anything above zero is a hot-path regression.
+static double perEvent(std::uint64_t allocations, std::uint64_t events)
+{
+    return events == 0 ? 0.0 : static_cast<double>(allocations) / static_cast<double>(events);
+}
+
+static void recordInterval(inputTester::intervalHistogram& intervals, std::uint64_t& lastNs, std::uint64_t nowNs)
+{
+    if (lastNs != 0 && nowNs > lastNs)
+    {
+        intervals.record(nowNs - lastNs);
+    }
+    lastNs = nowNs;
+}
+
+static void reportIntervals(benchmark::State& state, const inputTester::intervalHistogram& intervals)
+{
+    const auto summary = intervals.summarize();
+    state.counters["interval_p50_ns"] = static_cast<double>(summary.p50Ns);
+    state.counters["interval_p99_ns"] = static_cast<double>(summary.p99Ns);
+    state.counters["interval_jitter_ns"] = summary.jitterNs;
+    state.counters["interval_outliers"] = static_cast<double>(summary.outliers);
+}
+
 // Tight-loop throughput-ish benchmark (enqueue as fast as possible; consumer drains continuously).
-static void bmSpscRingBuffer(benchmark::State& state)
+// Instantiated for both index policies so shared vs. cached opposite indices show up side by side.
+template <inputTester::spscIndexPolicy indexPolicy> static void bmSpscRingBuffer(benchmark::State& state)
 {
     using value_type = std::int_fast64_t;
-    using fifo_type = SpscRingBufferAdapter<value_type>;
+    using fifo_type = SpscRingBufferAdapter<value_type, indexPolicy>;
 
     fifo_type fifo(g_benchSize);
 
@@ -115,13 +160,307 @@ static void bmSpscRingBuffer(benchmark::State& state)
     consumerThread.join();
 }
 
+// Same as bmSpscRingBuffer, but both sides move state.range(0) values per index publish.
+static void bmSpscRingBufferBatch(benchmark::State& state)
+{
+    using value_type = std::int_fast64_t;
+    using fifo_type = SpscRingBufferAdapter<value_type>;
+
+    const auto batchSize = static_cast<std::size_t>(state.range(0));
+    fifo_type fifo(g_benchSize);
+
+    std::thread consumerThread([&]() {
+        pinThread(g_consumerCpu);
+        std::vector<value_type> batch(batchSize);
+        auto expected = value_type{};
+        for (;;)
+        {
+            const auto count = fifo.popBatch(batch);
+            if (count == 0)
+            {
+                cpuRelax();
+                continue;
+            }
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto val = batch[i];
+                benchmark::DoNotOptimize(val);
+                if (val == -1)
+                {
+                    return;
+                }
+                if (val != expected)
+                {
+                    throw std::runtime_error("invalid value");
+                }
+                ++expected;
+            }
+        }
+    });
+
+    std::vector<value_type> batch(batchSize);
+    auto value = value_type{};
+    pinThread(g_producerCpu);
+    for (auto _ : state)
+    {
+        for (auto& item : batch)
+        {
+            item = value++;
+        }
+        std::span<const value_type> pending{ batch };
+        while (!pending.empty())
+        {
+            const auto pushed = fifo.pushBatch(pending);
+            if (pushed == 0)
+            {
+                cpuRelax();
+            }
+            pending = pending.subspan(pushed);
+        }
+    }
+
+    state.counters["ops/sec"] = benchmark::Counter(double(value), benchmark::Counter::kIsRate);
+    {
+        // Signal the consumer to stop.
+        while (not fifo.push(-1))
+        {
+            cpuRelax();
+        }
+    }
+
+    consumerThread.join();
+}
+
+// 40-byte inputEvent throughput: build on the stack + tryPush/tryPop copies vs. reserve/commit + peek/release in place.
+using benchEventQueue = inputTester::spscRingBuffer<inputTester::inputEvent, 1024>;
+static constexpr std::uint32_t g_stopScanCode = 0xFFFFFFFFU;
+
+static void fillBenchEvent(inputTester::inputEvent& event, std::uint32_t seq)
+{
+    event.sourceTimestampNs = seq;
+    event.receiveTimestampNs = seq;
+    event.deviceId = 1;
+    event.device = inputTester::deviceType::keyboard;
+    event.kind = (seq & 1U) != 0 ? inputTester::eventKind::keyUp : inputTester::eventKind::keyDown;
+    event.virtualKey = seq & 0xFFU;
+    event.scanCode = seq;
+}
+
+static void bmSpscEventCopy(benchmark::State& state)
+{
+    static_assert(sizeof(inputTester::inputEvent) == 40);
+    auto queue = std::make_unique<benchEventQueue>();
+
+    std::thread consumerThread([&]() {
+        pinThread(g_consumerCpu);
+        for (std::uint32_t expected = 0;; ++expected)
+        {
+            inputTester::inputEvent event{};
+            while (not queue->tryPop(event))
+            {
+                cpuRelax();
+            }
+            benchmark::DoNotOptimize(event);
+            if (event.scanCode == g_stopScanCode)
+            {
+                break;
+            }
+            if (event.scanCode != expected)
+            {
+                throw std::runtime_error("invalid value");
+            }
+        }
+    });
+
+    std::uint32_t seq = 0;
+    pinThread(g_producerCpu);
+    std::uint64_t allocations = 0;
+    for (auto _ : state)
+    {
+        // Scoped per iteration so the benchmark loop's own bookkeeping is not counted.
+        const allocationTracker::Region region{};
+        inputTester::inputEvent event{};
+        fillBenchEvent(event, seq);
+        while (not queue->tryPush(event))
+        {
+            cpuRelax();
+        }
+        ++seq;
+        allocations += region.allocations();
+    }
+
+    state.counters["ops/sec"] = benchmark::Counter(double(seq), benchmark::Counter::kIsRate);
+    state.counters["allocs/event"] = perEvent(allocations, seq);
+    state.counters["slot_bytes"] = static_cast<double>(sizeof(inputTester::inputEvent));
+    state.counters["ring_events"] = static_cast<double>(queue->capacity());
+    {
+        inputTester::inputEvent stop{};
+        stop.scanCode = g_stopScanCode;
+        while (not queue->tryPush(stop))
+        {
+            cpuRelax();
+        }
+    }
+
+    consumerThread.join();
+}
+
+static void bmSpscEventInPlace(benchmark::State& state)
+{
+    auto queue = std::make_unique<benchEventQueue>();
+
+    std::thread consumerThread([&]() {
+        pinThread(g_consumerCpu);
+        std::uint32_t expected = 0;
+        for (;;)
+        {
+            const auto pending = queue->peek();
+            if (pending.empty())
+            {
+                cpuRelax();
+                continue;
+            }
+            for (const auto& event : pending)
+            {
+                benchmark::DoNotOptimize(event);
+                if (event.scanCode == g_stopScanCode)
+                {
+                    return;
+                }
+                if (event.scanCode != expected)
+                {
+                    throw std::runtime_error("invalid value");
+                }
+                ++expected;
+            }
+            queue->release(pending.size());
+        }
+    });
+
+    std::uint32_t seq = 0;
+    pinThread(g_producerCpu);
+    std::uint64_t allocations = 0;
+    for (auto _ : state)
+    {
+        // Scoped per iteration so the benchmark loop's own bookkeeping is not counted.
+        const allocationTracker::Region region{};
+        inputTester::inputEvent* slot = nullptr;
+        while ((slot = queue->reserve()) == nullptr)
+        {
+            cpuRelax();
+        }
+        *slot = inputTester::inputEvent{};
+        fillBenchEvent(*slot, seq);
+        queue->commit();
+        ++seq;
+        allocations += region.allocations();
+    }
+
+    state.counters["ops/sec"] = benchmark::Counter(double(seq), benchmark::Counter::kIsRate);
+    state.counters["allocs/event"] = perEvent(allocations, seq);
+    {
+        inputTester::inputEvent* slot = nullptr;
+        while ((slot = queue->reserve()) == nullptr)
+        {
+            cpuRelax();
+        }
+        slot->scanCode = g_stopScanCode;
+        queue->commit();
+    }
+
+    consumerThread.join();
+}
+
+// Same traffic as bmSpscEventCopy through 16-byte packedInputEvent slots: pack + tryPush on the producer,
+// tryPop + unpack on the consumer. The ring has twice the slots in 32 KB instead of 40 KB, so twice the history.
+// The stop event does not fit a packed slot and takes the escaped path.
+using benchPackedQueue = inputTester::spscRingBuffer<inputTester::packedInputEvent, 2048>;
+// Keeps sequence-numbered scan codes within the 12 bits a single packed slot holds.
+static constexpr std::uint32_t g_packedScanCodeMask = 0xFFFU;
+
+static void bmSpscPackedEvent(benchmark::State& state)
+{
+    static_assert(sizeof(benchPackedQueue) < sizeof(benchEventQueue), "packed ring should use less memory");
+    auto queue = std::make_unique<benchPackedQueue>();
+
+    std::thread consumerThread([&]() {
+        pinThread(g_consumerCpu);
+        inputTester::packedEventDecoder decoder{};
+        for (std::uint64_t expected = 0;;)
+        {
+            inputTester::packedInputEvent slot{};
+            while (not queue->tryPop(slot))
+            {
+                cpuRelax();
+            }
+            inputTester::inputEvent event{};
+            if (not decoder.feed(slot, event))
+            {
+                continue;
+            }
+            benchmark::DoNotOptimize(event);
+            if (event.scanCode == g_stopScanCode)
+            {
+                break;
+            }
+            if (event.sourceTimestampNs != expected)
+            {
+                throw std::runtime_error("invalid value");
+            }
+            ++expected;
+        }
+    });
+
+    inputTester::packedEventEncoder encoder{};
+    std::uint32_t seq = 0;
+    pinThread(g_producerCpu);
+    std::uint64_t allocations = 0;
+    for (auto _ : state)
+    {
+        // Scoped per iteration so the benchmark loop's own bookkeeping is not counted.
+        const allocationTracker::Region region{};
+        inputTester::inputEvent event{};
+        fillBenchEvent(event, seq);
+        event.scanCode &= g_packedScanCodeMask;
+        inputTester::packedInputEvent slot{};
+        if (not encoder.tryPack(event, slot))
+        {
+            throw std::runtime_error("event should pack");
+        }
+        while (not queue->tryPush(slot))
+        {
+            cpuRelax();
+        }
+        ++seq;
+        allocations += region.allocations();
+    }
+
+    state.counters["ops/sec"] = benchmark::Counter(double(seq), benchmark::Counter::kIsRate);
+    state.counters["allocs/event"] = perEvent(allocations, seq);
+    state.counters["slot_bytes"] = static_cast<double>(sizeof(inputTester::packedInputEvent));
+    state.counters["ring_events"] = static_cast<double>(queue->capacity());
+    {
+        inputTester::inputEvent stop{};
+        stop.scanCode = g_stopScanCode;
+        std::array<inputTester::packedInputEvent, inputTester::escapedSlotCount> escaped{};
+        encoder.packEscaped(stop, escaped);
+        while (not queue->tryPushAll(escaped))
+        {
+            cpuRelax();
+        }
+    }
+
+    consumerThread.join();
+}
+
 // Rate + periodic drain benchmark for "mouse @ N Hz, UI drains every M ms".
 //
 // This models InputTester’s architecture:
 // - Producer: input backend thread pushing events continuously
 // - Consumer: UI thread waking periodically and draining the queue
 //
-// It reports drop rate (when tryPush fails) and event "age" on consumption (p50/p99).
+// It reports drop rate (when tryPush fails), event "age" on consumption (p50/p99) and how steadily the
+// producer kept its period (source-time intervals of the consumed events).
 static void bmSpscMouseRateDrain(benchmark::State& state)
 {
     const auto producerHz = static_cast<std::uint32_t>(state.range(0));
@@ -138,6 +477,8 @@ static void bmSpscMouseRateDrain(benchmark::State& state)
     std::vector<std::uint64_t> agesNs;
     const auto expectedEvents = static_cast<std::uint64_t>(producerHz) * durationMs / 1000ULL;
     agesNs.reserve(static_cast<std::size_t>(expectedEvents));
+    inputTester::intervalHistogram intervals{};
+    std::uint64_t lastSourceNs = 0;
 
     std::thread producerThread([&]() {
         pinThread(g_producerCpu);
@@ -151,10 +492,11 @@ static void bmSpscMouseRateDrain(benchmark::State& state)
             next += period;
 
             inputTester::inputEvent event{};
-            event.timestampNs = inputTester::nowTimestampNs();
+            event.sourceTimestampNs = inputTester::nowTimestampNs();
+            event.receiveTimestampNs = event.sourceTimestampNs;
             event.deviceId = 1;
             event.device = inputTester::deviceType::mouse;
-            event.kind = inputTester::eventKind::unknown;
+            event.kind = inputTester::eventKind::motion;
             event.scanCode = static_cast<std::uint32_t>(seq);
             ++seq;
 
@@ -195,7 +537,8 @@ static void bmSpscMouseRateDrain(benchmark::State& state)
             while (queue.tryPop(event))
             {
                 const std::uint64_t now = inputTester::nowTimestampNs();
-                agesNs.push_back(now - event.timestampNs);
+                agesNs.push_back(now - event.sourceTimestampNs);
+                recordInterval(intervals, lastSourceNs, event.sourceTimestampNs);
             }
 
             nextDrain += drainPeriod;
@@ -213,15 +556,6 @@ static void bmSpscMouseRateDrain(benchmark::State& state)
 
     std::sort(agesNs.begin(), agesNs.end());
 
-    auto ageAtPercentile = [&](double p) -> std::uint64_t {
-        if (agesNs.empty())
-        {
-            return 0;
-        }
-        const auto idx = static_cast<std::size_t>((p / 100.0) * (static_cast<double>(agesNs.size() - 1)));
-        return agesNs[idx];
-    };
-
     const double durationSeconds = static_cast<double>(durationMs) / 1000.0;
     state.counters["producer_hz"] = static_cast<double>(producerHz);
     state.counters["drain_ms"] = static_cast<double>(drainMs);
@@ -231,12 +565,201 @@ static void bmSpscMouseRateDrain(benchmark::State& state)
     state.counters["consumed"] = static_cast<double>(consumedCount);
     state.counters["dropped"] = static_cast<double>(droppedCount);
     state.counters["drops/sec"] = durationSeconds > 0.0 ? (static_cast<double>(droppedCount) / durationSeconds) : 0.0;
-    state.counters["p50_age_ns"] = static_cast<double>(ageAtPercentile(50.0));
-    state.counters["p99_age_ns"] = static_cast<double>(ageAtPercentile(99.0));
-    state.counters["max_age_ns"] = static_cast<double>(ageAtPercentile(100.0));
+    state.counters["p50_age_ns"] = static_cast<double>(ageAtPercentile(agesNs, 50.0));
+    state.counters["p99_age_ns"] = static_cast<double>(ageAtPercentile(agesNs, 99.0));
+    state.counters["max_age_ns"] = static_cast<double>(ageAtPercentile(agesNs, 100.0));
+    reportIntervals(state, intervals);
+}
+
+// Same producer as bmSpscMouseRateDrain, but the consumer sleeps in poll() on the queue's eventfd and
+// drains as soon as it is signalled (empty -> non-empty), instead of waking on a fixed drain period.
+static void bmSpscMouseRateNotify(benchmark::State& state)
+{
+    const auto producerHz = static_cast<std::uint32_t>(state.range(0));
+    const auto durationMs = static_cast<std::uint32_t>(state.range(1));
+
+    inputTester::inputEventQueue queue{};
+    if (!queue.enableNotifications())
+    {
+        state.SkipWithError("eventfd notifications unavailable");
+        return;
+    }
+
+    std::atomic_bool stopRequested{ false };
+    std::atomic<std::uint64_t> produced{ 0 };
+
+    std::vector<std::uint64_t> agesNs;
+    const auto expectedEvents = static_cast<std::uint64_t>(producerHz) * durationMs / 1000ULL;
+    agesNs.reserve(static_cast<std::size_t>(expectedEvents));
+    inputTester::intervalHistogram intervals{};
+    std::uint64_t lastSourceNs = 0;
+    std::uint64_t wakeups = 0;
+
+    std::thread producerThread([&]() {
+        pinThread(g_producerCpu);
+
+        const auto period = std::chrono::nanoseconds(1'000'000'000ULL / producerHz);
+        auto next = steadyClock::now();
+        std::uint64_t seq = 0;
+
+        while (!stopRequested.load(std::memory_order_relaxed))
+        {
+            next += period;
+
+            inputTester::inputEvent event{};
+            event.sourceTimestampNs = inputTester::nowTimestampNs();
+            event.receiveTimestampNs = event.sourceTimestampNs;
+            event.deviceId = 1;
+            event.device = inputTester::deviceType::mouse;
+            event.kind = inputTester::eventKind::motion;
+            event.scanCode = static_cast<std::uint32_t>(seq);
+            ++seq;
+
+            produced.fetch_add(1, std::memory_order_relaxed);
+            queue.onInputEvent(event);
+
+            while (steadyClock::now() < next)
+            {
+                if (stopRequested.load(std::memory_order_relaxed))
+                {
+                    break;
+                }
+                cpuRelax();
+            }
+        }
+    });
+
+    pinThread(g_consumerCpu);
+
+    for (auto _ : state)
+    {
+        const auto end = steadyClock::now() + std::chrono::milliseconds(durationMs);
+        pollfd descriptor{ queue.notificationHandle(), POLLIN, 0 };
+
+        while (steadyClock::now() < end)
+        {
+            if (::poll(&descriptor, 1, 10) <= 0)
+            {
+                continue;
+            }
+            ++wakeups;
+            queue.acknowledgeNotification();
+            queue.drain([&](const inputTester::inputEvent& event) {
+                agesNs.push_back(inputTester::nowTimestampNs() - event.sourceTimestampNs);
+                recordInterval(intervals, lastSourceNs, event.sourceTimestampNs);
+            });
+        }
+
+        stopRequested.store(true, std::memory_order_relaxed);
+    }
+
+    producerThread.join();
+
+    std::sort(agesNs.begin(), agesNs.end());
+    const auto counters = queue.counters();
+    state.counters["producer_hz"] = static_cast<double>(producerHz);
+    state.counters["duration_ms"] = static_cast<double>(durationMs);
+    state.counters["produced"] = static_cast<double>(produced.load(std::memory_order_relaxed));
+    state.counters["consumed"] = static_cast<double>(agesNs.size());
+    state.counters["dropped"] = static_cast<double>(counters.dropped);
+    state.counters["wakeups"] = static_cast<double>(wakeups);
+    state.counters["p50_age_ns"] = static_cast<double>(ageAtPercentile(agesNs, 50.0));
+    state.counters["p99_age_ns"] = static_cast<double>(ageAtPercentile(agesNs, 99.0));
+    state.counters["max_age_ns"] = static_cast<double>(ageAtPercentile(agesNs, 100.0));
+    reportIntervals(state, intervals);
+}
+
+// N producer threads feeding one inputEventMergeQueue (one SPSC lane each) while the pinned consumer
+// drains the timestamp-ordered merge. Each iteration pushes g_mergeEventsPerProducer events per producer;
+// a full lane refuses the reservation, which the queue counts as a drop (reported as lane_full_drops), and the
+// producer retries the same event.
+static constexpr std::uint32_t g_mergeEventsPerProducer = 1U << 16;
+
+static void bmMpscMergeContention(benchmark::State& state)
+{
+    const auto producerCount = static_cast<std::size_t>(state.range(0));
+    std::uint64_t consumed = 0;
+    std::uint64_t drops = 0;
+    std::uint64_t allocations = 0;
+
+    pinThread(g_consumerCpu);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto queue = std::make_unique<inputTester::inputEventMergeQueue>(producerCount);
+        std::atomic_bool go{ false };
+        std::vector<std::thread> producers;
+        producers.reserve(producerCount);
+        for (std::size_t producer = 0; producer < producerCount; ++producer)
+        {
+            producers.emplace_back([&, producer]() {
+                while (!go.load(std::memory_order_acquire))
+                {
+                    cpuRelax();
+                }
+                for (std::uint32_t seq = 0; seq < g_mergeEventsPerProducer; ++seq)
+                {
+                    inputTester::inputEvent* slot = nullptr;
+                    while ((slot = queue->reserveEvent()) == nullptr)
+                    {
+                        cpuRelax();
+                    }
+                    slot->sourceTimestampNs = inputTester::nowTimestampNs();
+                    slot->receiveTimestampNs = slot->sourceTimestampNs;
+                    slot->deviceId = static_cast<std::uint32_t>(producer);
+                    slot->device = inputTester::deviceType::keyboard;
+                    slot->kind = inputTester::eventKind::keyDown;
+                    slot->scanCode = seq & g_packedScanCodeMask;
+                    queue->commitEvent();
+                }
+            });
+        }
+        std::vector<std::uint32_t> expected(producerCount, 0);
+        const auto total = static_cast<std::uint64_t>(producerCount) * g_mergeEventsPerProducer;
+        std::uint64_t received = 0;
+        state.ResumeTiming();
+
+        const allocationTracker::Region region{};
+        go.store(true, std::memory_order_release);
+        while (received < total)
+        {
+            const auto drained = queue->drain([&](const inputTester::inputEvent& event) {
+                benchmark::DoNotOptimize(event);
+                if (event.deviceId >= producerCount ||
+                    event.scanCode != (expected[event.deviceId] & g_packedScanCodeMask))
+                {
+                    throw std::runtime_error("invalid value");
+                }
+                ++expected[event.deviceId];
+            });
+            if (drained == 0)
+            {
+                cpuRelax();
+            }
+            received += drained;
+        }
+        allocations += region.allocations();
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+
+        consumed += received;
+        drops += queue->counters().dropped;
+    }
+
+    state.counters["producers"] = static_cast<double>(producerCount);
+    state.counters["ops/sec"] = benchmark::Counter(double(consumed), benchmark::Counter::kIsRate);
+    state.counters["lane_full_drops"] = static_cast<double>(drops);
+    state.counters["consumer_allocs/event"] = perEvent(allocations, consumed);
 }
 
-BENCHMARK(bmSpscRingBuffer);
+BENCHMARK_TEMPLATE(bmSpscRingBuffer, inputTester::spscIndexPolicy::shared);
+BENCHMARK_TEMPLATE(bmSpscRingBuffer, inputTester::spscIndexPolicy::cached);
+BENCHMARK(bmSpscRingBufferBatch)->Arg(8)->Arg(32)->Arg(128);
+BENCHMARK(bmSpscEventCopy);
+BENCHMARK(bmSpscEventInPlace);
+BENCHMARK(bmSpscPackedEvent);
 BENCHMARK(bmSpscMouseRateDrain)
     ->Args({ 8000, 16, 2000 })
     ->Args({ 8000, 32, 2000 })
@@ -245,5 +768,7 @@ BENCHMARK(bmSpscMouseRateDrain)
     ->Args({ 32000, 16, 2000 })
     ->Args({ 64000, 16, 2000 })
     ->Iterations(1);
+BENCHMARK(bmSpscMouseRateNotify)->Args({ 8000, 2000 })->Args({ 64000, 2000 })->Iterations(1);
+BENCHMARK(bmMpscMergeContention)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
 
 BENCHMARK_MAIN();
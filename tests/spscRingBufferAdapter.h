@@ -1,19 +1,25 @@
 #pragma once
 
 #include "inputtester/core/spscRingBuffer.h"
-#include <cassert>
 #include <cstddef>
+#include <span>
 
 constexpr std::size_t g_benchSize = 131072;
 
-template <typename T> class SpscRingBufferAdapter
+template <typename T, inputTester::spscIndexPolicy indexPolicy = inputTester::spscIndexPolicy::shared>
+class SpscRingBufferAdapter
 {
 public:
     using value_type = T;
 
-    explicit SpscRingBufferAdapter(std::size_t capacity) : m_buffer{}
+    explicit SpscRingBufferAdapter(std::size_t capacity, inputTester::ringMemoryOptions options = {})
+        : m_buffer{ capacity, options }
     {
-        assert(capacity == g_benchSize && "This adapter uses a fixed g_benchSize capacity");
+    }
+
+    std::size_t capacity() const
+    {
+        return m_buffer.capacity();
     }
     bool push(const T& item)
     {
@@ -25,11 +31,21 @@ public:
         return m_buffer.tryPop(item);
     }
 
+    std::size_t pushBatch(std::span<const T> items)
+    {
+        return m_buffer.tryPushBatch(items);
+    }
+
+    std::size_t popBatch(std::span<T> items)
+    {
+        return m_buffer.tryPopBatch(items);
+    }
+
     bool empty() const
     {
-        return m_buffer.isEmpty();
+        return m_buffer.size() == 0;
     }
 
 private:
-    inputTester::spscRingBuffer<T, g_benchSize> m_buffer;
+    inputTester::spscRingBuffer<T, inputTester::dynamicCapacity, indexPolicy> m_buffer;
 };
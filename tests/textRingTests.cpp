@@ -0,0 +1,184 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <QtTest/QTest>
+
+#include "inputtester/core/textRing.h"
+
+namespace
+{
+
+void appendUtf16(std::u16string& text, char32_t codePoint)
+{
+    if (codePoint > 0xFFFF)
+    {
+        codePoint -= 0x10000;
+        text.push_back(static_cast<char16_t>(0xD800 + (codePoint >> 10)));
+        text.push_back(static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF)));
+        return;
+    }
+    text.push_back(static_cast<char16_t>(codePoint));
+}
+
+// Stands in for the text widget: applies each delta the way KeyLogWindow edits its QPlainTextEdit.
+class shownText
+{
+public:
+    void apply(inputTester::textRing& ring)
+    {
+        const auto delta{ ring.takeDelta() };
+        text_.erase(0, delta.removeFrontUnits);
+        text_.erase(text_.size() - delta.removeBackUnits);
+        for (auto index = delta.appendFrom; index < ring.size(); ++index)
+        {
+            appendUtf16(text_, ring.at(index));
+        }
+    }
+
+    const std::u16string& text() const
+    {
+        return text_;
+    }
+
+private:
+    std::u16string text_;
+};
+
+std::u16string contents(const inputTester::textRing& ring)
+{
+    std::u16string result{};
+    for (std::size_t index = 0; index < ring.size(); ++index)
+    {
+        appendUtf16(result, ring.at(index));
+    }
+    return result;
+}
+
+} // namespace
+
+class textRingTests final : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void appendsOnlyNewText();
+    void dropsOldestWhenFull();
+    void backspaceCutsShownOrPendingText();
+    void countsSurrogatePairsAsTwoUnits();
+    void staysInSyncUnderRandomTyping();
+};
+
+void textRingTests::appendsOnlyNewText()
+{
+    inputTester::textRing ring{ 8 };
+    shownText view{};
+    ring.push(U'a');
+    ring.push(U'b');
+    QVERIFY(ring.hasPendingChanges());
+    view.apply(ring);
+    QVERIFY(!ring.hasPendingChanges());
+    QCOMPARE(view.text(), std::u16string{ u"ab" });
+
+    ring.push(U'c');
+    const auto delta{ ring.takeDelta() };
+    QCOMPARE(delta.removeFrontUnits, std::size_t{ 0 });
+    QCOMPARE(delta.removeBackUnits, std::size_t{ 0 });
+    QCOMPARE(delta.appendFrom, std::size_t{ 2 });
+}
+
+void textRingTests::dropsOldestWhenFull()
+{
+    inputTester::textRing ring{ 3 };
+    shownText view{};
+    for (const auto codePoint : std::u32string{ U"abc" })
+    {
+        ring.push(codePoint);
+    }
+    view.apply(ring);
+    ring.push(U'd');
+    ring.push(U'e');
+    QCOMPARE(ring.size(), std::size_t{ 3 });
+    QCOMPARE(ring.at(0), U'c');
+
+    const auto delta{ ring.takeDelta() };
+    QCOMPARE(delta.removeFrontUnits, std::size_t{ 2 });
+    QCOMPARE(delta.appendFrom, std::size_t{ 1 });
+
+    // Text that wraps out before it is ever shown costs nothing to remove.
+    for (const auto codePoint : std::u32string{ U"vwxyz" })
+    {
+        ring.push(codePoint);
+    }
+    QCOMPARE(ring.takeDelta().removeFrontUnits, std::size_t{ 3 });
+}
+
+void textRingTests::backspaceCutsShownOrPendingText()
+{
+    inputTester::textRing ring{ 8 };
+    shownText view{};
+    ring.push(U'a');
+    ring.push(U'b');
+    view.apply(ring);
+    ring.push(U'c');
+    QVERIFY(ring.backspace());
+    QVERIFY(ring.backspace());
+    ring.push(U'd');
+    view.apply(ring);
+    QCOMPARE(view.text(), std::u16string{ u"ad" });
+
+    ring.clear();
+    QVERIFY(!ring.backspace());
+    view.apply(ring);
+    QVERIFY(view.text().empty());
+}
+
+void textRingTests::countsSurrogatePairsAsTwoUnits()
+{
+    inputTester::textRing ring{ 2 };
+    shownText view{};
+    ring.push(U'\U0001F600');
+    ring.push(U'x');
+    view.apply(ring);
+    QCOMPARE(view.text().size(), std::size_t{ 3 });
+
+    ring.push(U'y');
+    QVERIFY(ring.backspace());
+    const auto delta{ ring.takeDelta() };
+    QCOMPARE(delta.removeFrontUnits, std::size_t{ 2 });
+    QCOMPARE(delta.removeBackUnits, std::size_t{ 0 });
+}
+
+void textRingTests::staysInSyncUnderRandomTyping()
+{
+    inputTester::textRing ring{ 16 };
+    shownText view{};
+    std::uint64_t state{ 987'654'321 };
+    for (int step = 0; step < 20'000; ++step)
+    {
+        state = state * 6'364'136'223'846'793'005ULL + 1'442'695'040'888'963'407ULL;
+        const auto roll{ state >> 56 };
+        if (roll < 48)
+        {
+            ring.backspace();
+        }
+        else if (roll < 56)
+        {
+            ring.push(static_cast<char32_t>(0x1F600 + (roll & 0xF)));
+        }
+        else
+        {
+            ring.push(static_cast<char32_t>(U'a' + roll % 26));
+        }
+        // Apply every few edits, like a frame boundary during fast typing.
+        if ((state >> 32) % 5 == 0)
+        {
+            view.apply(ring);
+            QCOMPARE(view.text(), contents(ring));
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(textRingTests)
+
+#include "textRingTests.moc"